@@ -0,0 +1,153 @@
+/*
+ * Throughput benchmark of VSTD_SPSC_QUEUE_DEFINE and VSTD_MPMC_QUEUE_DEFINE.
+ *
+ *   cc -std=gnu11 -O2 -pthread bench/queue_bench.c -o queue_bench
+ *   ./queue_bench [threads]
+ *
+ * Every run moves ITEMS items through a queue of CAPACITY slots, one item at a
+ * time and in batches of BATCH items, and prints the items moved per second.
+ * The MPMC runs use the given number of producers and consumers, 2 by
+ * default.
+ */
+#include "../vstd.h"
+
+#include <time.h>
+
+#define ITEMS (1u << 24)
+#define CAPACITY 1024
+#define BATCH 32
+
+VSTD_SPSC_QUEUE_DEFINE(SpscQueue, u64)
+VSTD_MPMC_QUEUE_DEFINE(MpmcQueue, u64)
+
+static SpscQueue spsc;
+static MpmcQueue mpmc;
+static usize batch;
+static usize threads;
+static _Atomic u64 popped;
+
+static f64 now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (f64)ts.tv_sec + (f64)ts.tv_nsec / 1e9;
+}
+
+static void *spsc_producer(void *arg) {
+  (void)arg;
+  u64 buf[BATCH];
+  for (u64 i = 0; i < ITEMS;) {
+    usize n = ITEMS - i < batch ? ITEMS - i : batch;
+    for (usize j = 0; j < n; ++j) {
+      buf[j] = i + j;
+    }
+    usize pushed = n == 1 ? SpscQueue_push(&spsc, i)
+                          : SpscQueue_push_n(&spsc, buf, n);
+    if (!pushed) {
+      sched_yield();
+    }
+    i += pushed;
+  }
+  return NULL;
+}
+
+static void *spsc_consumer(void *arg) {
+  u64 buf[BATCH];
+  u64 sum = 0;
+  for (u64 count = 0; count < ITEMS;) {
+    usize n = batch == 1 ? SpscQueue_pop(&spsc, buf)
+                         : SpscQueue_pop_n(&spsc, buf, batch);
+    if (!n) {
+      sched_yield();
+    }
+    for (usize j = 0; j < n; ++j) {
+      sum += buf[j];
+    }
+    count += n;
+  }
+  *(u64 *)arg = sum;
+  return NULL;
+}
+
+static void *mpmc_producer(void *arg) {
+  (void)arg;
+  u64 buf[BATCH];
+  for (u64 i = 0, count = ITEMS / threads; i < count;) {
+    usize n = count - i < batch ? count - i : batch;
+    for (usize j = 0; j < n; ++j) {
+      buf[j] = i + j;
+    }
+    usize pushed = n == 1 ? MpmcQueue_push(&mpmc, i)
+                          : MpmcQueue_push_n(&mpmc, buf, n);
+    if (!pushed) {
+      sched_yield();
+    }
+    i += pushed;
+  }
+  return NULL;
+}
+
+static void *mpmc_consumer(void *arg) {
+  u64 buf[BATCH];
+  u64 sum = 0;
+  while (atomic_load_explicit(&popped, memory_order_relaxed) <
+         ITEMS / threads * threads) {
+    usize n = batch == 1 ? MpmcQueue_pop(&mpmc, buf)
+                         : MpmcQueue_pop_n(&mpmc, buf, batch);
+    if (!n) {
+      sched_yield();
+      continue;
+    }
+    for (usize j = 0; j < n; ++j) {
+      sum += buf[j];
+    }
+    atomic_fetch_add_explicit(&popped, n, memory_order_relaxed);
+  }
+  *(u64 *)arg = sum;
+  return NULL;
+}
+
+static void report(const char *name, usize size, u64 items, f64 seconds) {
+  printf("%-5s batch %2zu: %8.2f M items/s\n", name, size,
+         (f64)items / seconds / 1e6);
+}
+
+int main(int argc, char **argv) {
+  threads = argc > 1 ? (usize)strtoul(argv[1], NULL, 10) : 2;
+  if (!threads) {
+    threads = 1;
+  }
+
+  pthread_t *ids = (pthread_t *)VSTD_MALLOC(sizeof(pthread_t) * threads * 2);
+  u64 *sums = (u64 *)VSTD_CALLOC(threads, sizeof(u64));
+  usize sizes[] = {1, BATCH};
+
+  for (usize s = 0; s < 2; ++s) {
+    batch = sizes[s];
+
+    spsc = SpscQueue_new(CAPACITY);
+    f64 start = now();
+    pthread_create(&ids[0], NULL, spsc_producer, NULL);
+    pthread_create(&ids[1], NULL, spsc_consumer, &sums[0]);
+    pthread_join(ids[0], NULL);
+    pthread_join(ids[1], NULL);
+    report("spsc", batch, ITEMS, now() - start);
+    SpscQueue_free(&spsc);
+
+    mpmc = MpmcQueue_new(CAPACITY);
+    atomic_store(&popped, 0);
+    start = now();
+    for (usize i = 0; i < threads; ++i) {
+      pthread_create(&ids[i], NULL, mpmc_producer, NULL);
+      pthread_create(&ids[threads + i], NULL, mpmc_consumer, &sums[i]);
+    }
+    for (usize i = 0; i < threads * 2; ++i) {
+      pthread_join(ids[i], NULL);
+    }
+    report("mpmc", batch, ITEMS / threads * threads, now() - start);
+    MpmcQueue_free(&mpmc);
+  }
+
+  VSTD_FREE(sums);
+  VSTD_FREE(ids);
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Stress test of VSTD_SPSC_QUEUE_DEFINE and VSTD_MPMC_QUEUE_DEFINE.
+ *
+ *   cc -std=gnu11 -O1 -g -pthread -fsanitize=thread tests/queue_stress.c
+ *
+ * The SPSC test checks that items arrive in order, and the MPMC test checks
+ * that every pushed item is popped exactly once, by comparing their count and
+ * sum. Single and batch pushes and pops are mixed on both queues, and the
+ * queues are kept small, so they're often full or empty.
+ */
+#include "../vstd.h"
+
+#define COUNT 100000
+#define PRODUCERS 4
+#define CONSUMERS 4
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      exit(1);                                                                 \
+    }                                                                          \
+  } while (0)
+
+VSTD_SPSC_QUEUE_DEFINE(SpscQueue, u64)
+VSTD_MPMC_QUEUE_DEFINE(MpmcQueue, u64)
+
+static SpscQueue spsc;
+static MpmcQueue mpmc;
+static _Atomic u64 popped_count;
+static _Atomic u64 popped_sum;
+
+static void *spsc_producer(void *arg) {
+  (void)arg;
+  u64 buf[7];
+  for (u64 i = 0; i < COUNT;) {
+    if (i % 3) {
+      while (!SpscQueue_push(&spsc, i)) {
+        sched_yield();
+      }
+      i++;
+      continue;
+    }
+
+    usize n = 0;
+    for (; n < 7 && i + n < COUNT; ++n) {
+      buf[n] = i + n;
+    }
+    for (usize done = 0; done < n;) {
+      usize pushed = SpscQueue_push_n(&spsc, buf + done, n - done);
+      if (!pushed) {
+        sched_yield();
+      }
+      done += pushed;
+    }
+    i += n;
+  }
+  return NULL;
+}
+
+static void *spsc_consumer(void *arg) {
+  (void)arg;
+  u64 buf[5];
+  for (u64 expected = 0; expected < COUNT;) {
+    usize n = expected % 2 ? SpscQueue_pop(&spsc, buf)
+                           : SpscQueue_pop_n(&spsc, buf, 5);
+    if (!n) {
+      sched_yield();
+    }
+    for (usize i = 0; i < n; ++i) {
+      CHECK(buf[i] == expected);
+      expected++;
+    }
+  }
+  return NULL;
+}
+
+static void *mpmc_producer(void *arg) {
+  u64 base = (u64)(uptr)arg * COUNT;
+  u64 buf[8];
+  for (u64 i = 0; i < COUNT;) {
+    if (i & 1) {
+      while (!MpmcQueue_push(&mpmc, base + i)) {
+        sched_yield();
+      }
+      i++;
+      continue;
+    }
+
+    usize n = 0;
+    for (; n < 8 && i + n < COUNT; ++n) {
+      buf[n] = base + i + n;
+    }
+    for (usize done = 0; done < n;) {
+      usize pushed = MpmcQueue_push_n(&mpmc, buf + done, n - done);
+      if (!pushed) {
+        sched_yield();
+      }
+      done += pushed;
+    }
+    i += n;
+  }
+  return NULL;
+}
+
+static void *mpmc_consumer(void *arg) {
+  (void)arg;
+  u64 buf[6];
+  u64 sum = 0;
+  for (usize round = 0;
+       atomic_load(&popped_count) < (u64)PRODUCERS * COUNT; ++round) {
+    usize n = round & 1 ? MpmcQueue_pop_n(&mpmc, buf, 6)
+                        : MpmcQueue_pop(&mpmc, buf);
+    if (!n) {
+      sched_yield();
+    }
+    for (usize i = 0; i < n; ++i) {
+      sum += buf[i];
+    }
+    atomic_fetch_add(&popped_count, n);
+  }
+  atomic_fetch_add(&popped_sum, sum);
+  return NULL;
+}
+
+int main(void) {
+  pthread_t threads[PRODUCERS + CONSUMERS];
+
+  spsc = SpscQueue_new(60);
+  CHECK(spsc.cap == 64);
+  pthread_create(&threads[0], NULL, spsc_producer, NULL);
+  pthread_create(&threads[1], NULL, spsc_consumer, NULL);
+  pthread_join(threads[0], NULL);
+  pthread_join(threads[1], NULL);
+  CHECK(SpscQueue_len(&spsc) == 0);
+  SpscQueue_free(&spsc);
+
+  mpmc = MpmcQueue_new(100);
+  for (uptr i = 0; i < PRODUCERS; ++i) {
+    pthread_create(&threads[i], NULL, mpmc_producer, (void *)i);
+  }
+  for (usize i = 0; i < CONSUMERS; ++i) {
+    pthread_create(&threads[PRODUCERS + i], NULL, mpmc_consumer, NULL);
+  }
+  for (usize i = 0; i < PRODUCERS + CONSUMERS; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+
+  u64 total = (u64)PRODUCERS * COUNT;
+  CHECK(atomic_load(&popped_count) == total);
+  CHECK(atomic_load(&popped_sum) == total * (total - 1) / 2);
+  CHECK(MpmcQueue_len(&mpmc) == 0);
+  MpmcQueue_free(&mpmc);
+
+  printf("queue stress test passed\n");
+  return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * Test of _VSTD_Strings bound to a _VSTD_Allocator.
+ *
+ *   cc -std=gnu11 -O1 -g -fsanitize=address,undefined tests/string_allocator.c
+ *
+ * A counting allocator checks that every allocation of a bound string goes
+ * through it, also after the string is freed and reused, and that every
+ * allocated block is freed exactly once.
+ */
+#include "../vstd.h"
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      exit(1);                                                                 \
+    }                                                                          \
+  } while (0)
+
+typedef struct {
+  usize allocs;
+  usize frees;
+  usize live;
+} Counter;
+
+static void *counter_alloc(void *ctx, usize size) {
+  Counter *counter = (Counter *)ctx;
+  counter->allocs++;
+  counter->live += size;
+  return VSTD_MALLOC(size);
+}
+
+static void *counter_realloc(void *ctx, void *ptr, usize old_size,
+                             usize new_size) {
+  Counter *counter = (Counter *)ctx;
+  counter->allocs++;
+  counter->live += new_size - old_size;
+  return VSTD_REALLOC(ptr, new_size);
+}
+
+static void counter_free(void *ctx, void *ptr, usize size) {
+  Counter *counter = (Counter *)ctx;
+  counter->frees++;
+  counter->live -= size;
+  VSTD_FREE(ptr);
+}
+
+int main(void) {
+  Counter counter = {0};
+  VSTD_Allocator allocator = {&counter, counter_alloc, counter_realloc,
+                              counter_free};
+
+  VSTD_String string = vstd_string_with_allocator(4, &allocator);
+  CHECK(counter.allocs == 1);
+  vstd_string_push_str(&string, "bound to the allocator");
+  CHECK(vstd_string_allocator(&string) == &allocator);
+
+  vstd_string_free(&string);
+  CHECK(counter.frees == 1);
+  CHECK(counter.live == 0);
+  CHECK(vstd_string_allocator(&string) == &allocator);
+  CHECK(vstd_string_len(&string) == 0);
+  CHECK(vstd_string_compare(&string, "") == VSTD_STRING_EQUAL);
+
+  vstd_string_free(&string);
+  CHECK(counter.frees == 1);
+
+  usize allocs = counter.allocs;
+  vstd_string_push(&string, 'a');
+  CHECK(counter.allocs == allocs + 1);
+  CHECK(vstd_string_allocator(&string) == &allocator);
+  vstd_string_push_str(&string, "fter free");
+  CHECK(vstd_string_compare(&string, "after free") == VSTD_STRING_EQUAL);
+
+  VSTD_String clone = vstd_string_clone(&string);
+  CHECK(vstd_string_allocator(&clone) == &allocator);
+  vstd_string_free(&clone);
+
+  vstd_string_free(&string);
+  CHECK(counter.live == 0);
+  CHECK(counter.frees == 3);
+
+  VSTD_String heap = vstd_string_from("not bound to any allocator at all");
+  vstd_string_free(&heap);
+  CHECK(vstd_string_allocator(&heap) == NULL);
+  CHECK(vstd_string_len(&heap) == 0);
+
+  printf("string allocator test passed\n");
+  return 0;
+}
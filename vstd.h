@@ -33,16 +33,28 @@
  *
  * */
 
+#include <ctype.h>
 #include <dirent.h>
 #include <errno.h>
 #include <inttypes.h>
 #include <memory.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 typedef int8_t i8;
 typedef int16_t i16;
@@ -76,1070 +88,10951 @@ typedef double f64;
 /*****************************************************************************
  *
  * @section
- *   VSTD String
- *
- */
-
-/*****************************************************************************
- *
- * @type:
- *   _VSTD_String
+ *   VSTD Allocator
  *
- * @description:
- *   String implementation, this struct never allocates memory for itself, but
- *   only for its underlying pointer. When passing an instance of this type, its
- *   safe to pass it as it is to a function, as long as that function doesn't
- *   modify the string's pointer or other properties. Otherwise you should pass
- *   it as a reference, or you may lose the underlying pointer.
+ * @description
+ *   Every allocation made by the library goes through the VSTD_MALLOC,
+ *   VSTD_CALLOC, VSTD_REALLOC and VSTD_FREE macros, which can be defined before
+ *   including this header to replace the global heap at compile time. At
+ *   runtime containers can be bound to a _VSTD_Allocator instead, a NULL
+ *   allocator always stands for the global heap.
  *
  * */
-struct _VSTD_String {
-  char *ptr;
-  usize len;
-  usize cap;
-};
 
-#ifdef VSTD_STRING_STRIP_PREFIX
-typedef struct _VSTD_String String;
-#define _VSTD_String String
-#else
-typedef struct _VSTD_String VSTD_String;
-#define _VSTD_String VSTD_String
+#ifndef VSTD_MALLOC
+#define VSTD_MALLOC(size) malloc(size)
 #endif
 
-#ifndef VSTD_STRING_INITIAL_CAP
-#define VSTD_STRING_INITIAL_CAP 1
+#ifndef VSTD_CALLOC
+#define VSTD_CALLOC(count, size) calloc(count, size)
 #endif
 
-#define VSTD_STRING_EQUAL 0
+#ifndef VSTD_REALLOC
+#define VSTD_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+
+#ifndef VSTD_FREE
+#define VSTD_FREE(ptr) free(ptr)
+#endif
 
 /*****************************************************************************
  *
- * @section
- *   VSTD String function declarations
+ * @type:
+ *   _VSTD_Allocator
+ *
+ * @description:
+ *   Allocator interface, ctx is passed to every function as the first argument.
+ *   Sizes of the blocks are passed to realloc and free too, so allocators don't
+ *   need to store them. A container bound to an allocator only stores a pointer
+ *   to it, so the allocator must outlive every container bound to it.
  *
  * */
+struct _VSTD_Allocator {
+  void *ctx;
+  void *(*alloc)(void *ctx, usize size);
+  void *(*realloc)(void *ctx, void *ptr, usize old_size, usize new_size);
+  void (*free)(void *ctx, void *ptr, usize size);
+};
+
+#ifdef VSTD_ALLOCATOR_STRIP_PREFIX
+typedef struct _VSTD_Allocator Allocator;
+#define _VSTD_Allocator Allocator
+#else
+typedef struct _VSTD_Allocator VSTD_Allocator;
+#define _VSTD_Allocator VSTD_Allocator
+#endif
 
 /*****************************************************************************
  *
  * @function
- *   vstd_string_new
+ *   vstd_alloc
  *
  * @description
- *   Creates a new empty _VSTD_String object, this function internally calls
- *   vstd_string_with_capacity with VSTD_STRING_INITIAL_CAP as the argument.
+ *   Allocates a block of memory from the allocator, or from the global heap if
+ *   the allocator is NULL.
+ *
+ * @param[in]
+ *   allocator : _VSTD_Allocator to allocate from, or NULL.
+ * @param[in]
+ *   size : Size of the block in bytes.
  *
  * @return
- *   New empty _VSTD_String with capacity of VSTD_STRING_INITIAL_CAP.
+ *   Pointer to the allocated block.
  *
  * */
-VSTD_INLINE _VSTD_String vstd_string_new();
+VSTD_INLINE void *vstd_alloc(const _VSTD_Allocator *allocator, usize size) {
+  if (!allocator) {
+    return VSTD_MALLOC(size);
+  }
+  return allocator->alloc(allocator->ctx, size);
+}
 
 /*****************************************************************************
  *
  * @function
- *   vstd_string_with_capacity
+ *   vstd_alloc_zeroed
  *
  * @description
- *   Creates a new empty _VSTD_String object with the given capacity.
+ *   Allocates a zero initialized block of memory from the allocator, or from
+ *   the global heap if the allocator is NULL.
  *
  * @param[in]
- *   cap : Capacity for the new _VSTD_String.
+ *   allocator : _VSTD_Allocator to allocate from, or NULL.
+ * @param[in]
+ *   size : Size of the block in bytes.
  *
  * @return
- *   New empty _VSTD_String with given capacity.
+ *   Pointer to the allocated block.
  *
  * */
-VSTD_STATIC _VSTD_String vstd_string_with_capacity(usize cap);
+VSTD_INLINE void *vstd_alloc_zeroed(const _VSTD_Allocator *allocator,
+                                    usize size) {
+  if (!allocator) {
+    return VSTD_CALLOC(size, 1);
+  }
+
+  void *ptr = allocator->alloc(allocator->ctx, size);
+  memset(ptr, 0, size);
+  return ptr;
+}
 
 /*****************************************************************************
  *
  * @function
- *   vstd_string_from
+ *   vstd_realloc
  *
  * @description
- *   Creates a new null terminated _VSTD_String from given C string.
+ *   Resizes a block of memory allocated from the allocator, or from the global
+ *   heap if the allocator is NULL. A NULL pointer is allocated like vstd_alloc.
  *
  * @param[in]
- *   str : Null terminated C string to copy from.
+ *   allocator : _VSTD_Allocator the block was allocated from, or NULL.
+ * @param[in]
+ *   ptr : Pointer to the block.
+ * @param[in]
+ *   old_size : Current size of the block in bytes.
+ * @param[in]
+ *   new_size : New size of the block in bytes.
  *
  * @return
- *   New null terminated _VSTD_String with the same contents as the given C
- *   string.
+ *   Pointer to the resized block.
  *
  * */
-VSTD_STATIC _VSTD_String vstd_string_from(const char *str);
+VSTD_INLINE void *vstd_realloc(const _VSTD_Allocator *allocator, void *ptr,
+                               usize old_size, usize new_size) {
+  if (!allocator) {
+    return VSTD_REALLOC(ptr, new_size);
+  }
+  return allocator->realloc(allocator->ctx, ptr, old_size, new_size);
+}
 
 /*****************************************************************************
  *
  * @function
- *   vstd_string_clone
+ *   vstd_free
  *
  * @description
- *   Clones the given _VSTD_String and returns the clone.
+ *   Frees a block of memory allocated from the allocator, or from the global
+ *   heap if the allocator is NULL.
  *
  * @param[in]
- *   string : _VSTD_String to clone.
- *
- * @return
- *   New _VSTD_String identical to the given _VSTD_String.
+ *   allocator : _VSTD_Allocator the block was allocated from, or NULL.
+ * @param[in]
+ *   ptr : Pointer to the block.
+ * @param[in]
+ *   size : Size of the block in bytes.
  *
  * */
-VSTD_STATIC _VSTD_String vstd_string_clone(const _VSTD_String *string);
+VSTD_INLINE void vstd_free(const _VSTD_Allocator *allocator, void *ptr,
+                           usize size) {
+  if (!allocator) {
+    VSTD_FREE(ptr);
+    return;
+  }
+  allocator->free(allocator->ctx, ptr, size);
+}
 
 /*****************************************************************************
  *
- * @function
- *   vstd_string_format
+ * @section
+ *   VSTD Search
  *
  * @description
- *   Creates a new _VSTD_String using the formatted contents.
- *
- * @param[in]
- *   fmt : Null terminated C string specifying how to interpret the data.
- * @param[in]
- *   ... : Arguments specifying the data to format.
- *
- * @return
- *   New _VSTD_String with the formatted contents.
+ *   Length based substring search kernels used by _VSTD_String and
+ *   _VSTD_StrView functions. When SSE2 or AVX2 is available, the haystack is
+ *   filtered a vector at a time by comparing it with the first and the last
+ *   byte of the needle, and only the candidates passing the filter are
+ *   compared byte by byte. Otherwise a scalar fallback is used.
  *
  * */
-VSTD_STATIC _VSTD_String vstd_string_format(const char *fmt, ...);
+
+#if defined(__AVX2__)
+#define _VSTD_SIMD_WIDTH 32
+typedef __m256i _VSTD_Simd;
+
+VSTD_INLINE _VSTD_Simd _vstd_simd_splat(char c) { return _mm256_set1_epi8(c); }
+
+VSTD_INLINE u32 _vstd_simd_match2(const char *a, _VSTD_Simd va, const char *b,
+                                  _VSTD_Simd vb) {
+  __m256i ea = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)a), va);
+  __m256i eb = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)b), vb);
+  return (u32)_mm256_movemask_epi8(_mm256_and_si256(ea, eb));
+}
+#elif defined(__SSE2__)
+#define _VSTD_SIMD_WIDTH 16
+typedef __m128i _VSTD_Simd;
+
+VSTD_INLINE _VSTD_Simd _vstd_simd_splat(char c) { return _mm_set1_epi8(c); }
+
+VSTD_INLINE u32 _vstd_simd_match2(const char *a, _VSTD_Simd va, const char *b,
+                                  _VSTD_Simd vb) {
+  __m128i ea = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)a), va);
+  __m128i eb = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)b), vb);
+  return (u32)_mm_movemask_epi8(_mm_and_si128(ea, eb));
+}
+#endif
 
 /*****************************************************************************
  *
  * @function
- *   vstd_string_push
+ *   _vstd_mem_find
  *
  * @description
- *   Adds a character to the end of given _VSTD_String, this function may resize
- *   the supplied _VSTD_String.
+ *   Tries to find the first occurrence of the needle inside of the haystack,
+ *   both are length based, so they may contain null characters. This is a
+ *   helper function and it's only meant to be used the vstd library functions.
  *
  * @param[in]
- *   string : _VSTD_String to modify.
+ *   hay : Memory to search.
  * @param[in]
- *   c : Character to push.
+ *   hay_len : Length of the memory to search.
+ * @param[in]
+ *   needle : Memory to search for.
+ * @param[in]
+ *   needle_len : Length of the memory to search for.
  *
  * @return
- *   Pointer to same modified _VSTD_String.
+ *   Pointer to the needle's first occurrence or a NULL pointer.
  *
  * */
-VSTD_STATIC _VSTD_String *vstd_string_push(_VSTD_String *string, char c);
+VSTD_STATIC const char *_vstd_mem_find(const char *hay, usize hay_len,
+                                       const char *needle, usize needle_len) {
+  if (!needle_len) {
+    return hay;
+  }
+  if (needle_len > hay_len) {
+    return NULL;
+  }
+  if (needle_len == 1) {
+    return (const char *)memchr(hay, needle[0], hay_len);
+  }
+
+  usize last = needle_len - 1;
+  usize count = hay_len - last;
+  usize i = 0;
+
+#ifdef _VSTD_SIMD_WIDTH
+  _VSTD_Simd first_byte = _vstd_simd_splat(needle[0]);
+  _VSTD_Simd last_byte = _vstd_simd_splat(needle[last]);
+
+  for (; i + _VSTD_SIMD_WIDTH <= count; i += _VSTD_SIMD_WIDTH) {
+    u32 mask = _vstd_simd_match2(hay + i, first_byte, hay + i + last,
+                                 last_byte);
+    for (; mask; mask &= mask - 1) {
+      const char *ptr = hay + i + __builtin_ctz(mask);
+      if (memcmp(ptr + 1, needle + 1, last - 1) == 0) {
+        return ptr;
+      }
+    }
+  }
+#endif
+
+  for (const char *end = hay + count, *ptr = hay + i; ptr < end; ++ptr) {
+    ptr = (const char *)memchr(ptr, needle[0], end - ptr);
+    if (!ptr) {
+      return NULL;
+    }
+    if (ptr[last] == needle[last] &&
+        memcmp(ptr + 1, needle + 1, last - 1) == 0) {
+      return ptr;
+    }
+  }
+
+  return NULL;
+}
 
 /*****************************************************************************
  *
  * @function
- *   vstd_string_push_str
+ *   _vstd_mem_find_last
  *
  * @description
- *   Adds the C string to the end of given _VSTD_String, this function
- *   may resize the given _VSTD_String.
+ *   Tries to find the last occurrence of the needle inside of the haystack,
+ *   by searching the haystack backwards from its end. Both are length based,
+ *   so they may contain null characters. This is a helper function and it's
+ *   only meant to be used the vstd library functions.
  *
  * @param[in]
- *   string : _VSTD_String to modify.
+ *   hay : Memory to search.
  * @param[in]
- *   str : Null terminated C string to push.
+ *   hay_len : Length of the memory to search.
+ * @param[in]
+ *   needle : Memory to search for.
+ * @param[in]
+ *   needle_len : Length of the memory to search for.
  *
  * @return
- *   Pointer to same modified _VSTD_String.
+ *   Pointer to the needle's last occurrence or a NULL pointer.
  *
  * */
-VSTD_STATIC _VSTD_String *vstd_string_push_str(_VSTD_String *string,
-                                               const char *str);
+VSTD_STATIC const char *_vstd_mem_find_last(const char *hay, usize hay_len,
+                                            const char *needle,
+                                            usize needle_len) {
+  if (!needle_len) {
+    return hay + hay_len;
+  }
+  if (needle_len > hay_len) {
+    return NULL;
+  }
+
+  usize last = needle_len - 1;
+  usize count = hay_len - last;
+
+#ifdef _VSTD_SIMD_WIDTH
+  _VSTD_Simd first_byte = _vstd_simd_splat(needle[0]);
+  _VSTD_Simd last_byte = _vstd_simd_splat(needle[last]);
+
+  for (; count >= _VSTD_SIMD_WIDTH; count -= _VSTD_SIMD_WIDTH) {
+    usize i = count - _VSTD_SIMD_WIDTH;
+    u32 mask = _vstd_simd_match2(hay + i, first_byte, hay + i + last,
+                                 last_byte);
+    while (mask) {
+      usize bit = 31 - (usize)__builtin_clz(mask);
+      const char *ptr = hay + i + bit;
+      if (last == 0 || memcmp(ptr + 1, needle + 1, last - 1) == 0) {
+        return ptr;
+      }
+      mask &= ~((u32)1 << bit);
+    }
+  }
+#endif
+
+  for (const char *ptr = hay + count; ptr-- > hay;) {
+    if (ptr[0] == needle[0] && ptr[last] == needle[last] &&
+        (last == 0 || memcmp(ptr + 1, needle + 1, last - 1) == 0)) {
+      return ptr;
+    }
+  }
+
+  return NULL;
+}
 
 /*****************************************************************************
  *
- * @function
- *   vstd_string_remove
+ * @section
+ *   VSTD Hash
  *
  * @description
- *   Tries to remove a substring from the given _VSTD_String if it's present in
- *   it. Only removes the first occurrence of the substring.
- *
- * @param[in]
- *   string : _VSTD_String to modify.
- * @param[in]
- *   sub : Null terminated C string to remove.
- *
- * @return
- *   Pointer to same _VSTD_String, it may or may not be modified depending on
- *   whether or not the given C string is present in it.
+ *   Fast non-cryptographic hashing of byte buffers, based on wyhash. Every
+ *   step multiplies two 64 bit words into a 128 bit product and folds it, so
+ *   long inputs are hashed 48 bytes at a time. The hash is seeded, a random
+ *   seed makes the hashes unpredictable, which protects hash tables against
+ *   flooding with colliding keys. The hash values depend on the byte order of
+ *   the platform.
  *
  * */
-VSTD_STATIC _VSTD_String *vstd_string_remove(_VSTD_String *string,
-                                             const char *sub);
+
+#ifndef VSTD_HASH_SEED
+#define VSTD_HASH_SEED 0
+#endif
+
+#define _VSTD_HASH_SECRET0 0x2d358dccaa6c78a5ULL
+#define _VSTD_HASH_SECRET1 0x8bb84b93962eacc9ULL
+#define _VSTD_HASH_SECRET2 0x4b33a62ed433d4a3ULL
+#define _VSTD_HASH_SECRET3 0x4d5a2da51de1aa47ULL
 
 /*****************************************************************************
  *
  * @function
- *   vstd_string_remove_at
+ *   _vstd_hash_mum
  *
  * @description
- *   Removes n number of characters starting from the index from the given
- *   _VSTD_String.
+ *   Multiplies a and b into a 128 bit product, and stores its low half in a
+ *   and its high half in b. This is a helper function and it's only meant to
+ *   be used the vstd library functions.
  *
- * @param[in]
- *   string : _VSTD_String to modify.
- * @param[in]
- *   index : Starting index for removal.
- * @param[in]
- *   len : Number of characters to remove.
+ * */
+VSTD_INLINE void _vstd_hash_mum(u64 *a, u64 *b) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t r = (__uint128_t)*a * *b;
+  *a = (u64)r;
+  *b = (u64)(r >> 64);
+#else
+  u64 ha = *a >> 32, hb = *b >> 32, la = (u32)*a, lb = (u32)*b;
+  u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  u64 t = rl + (rm0 << 32);
+  u64 c = t < rl;
+  u64 lo = t + (rm1 << 32);
+  c += lo < t;
+  *a = lo;
+  *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+/*****************************************************************************
  *
- * @return
- *   Pointer to same modified _VSTD_String.
+ * @function
+ *   _vstd_hash_mix
+ *
+ * @description
+ *   Multiplies a and b into a 128 bit product, and folds its halves with xor.
+ *   This is a helper function and it's only meant to be used the vstd library
+ *   functions.
  *
  * */
-VSTD_STATIC _VSTD_String *vstd_string_remove_at(_VSTD_String *string,
-                                                usize index, usize len);
+VSTD_INLINE u64 _vstd_hash_mix(u64 a, u64 b) {
+  _vstd_hash_mum(&a, &b);
+  return a ^ b;
+}
 
 /*****************************************************************************
  *
  * @function
- *   vstd_string_find_first
+ *   _vstd_hash_read8
  *
  * @description
- *   Tries to find the first occurrence of the substring inside of the given
- *   _VSTD_String. Underlying implementation of this function just calls strstr
- *   from standard library. Returns a NULL pointer if it fails.
+ *   _vstd_hash_read8, _vstd_hash_read4 and _vstd_hash_read3 read 8, 4 and 1 to
+ *   3 bytes from an unaligned pointer. They're helper functions and they're
+ *   only meant to be used the vstd library functions.
  *
- * @param[in]
- *   string : _VSTD_String to search.
- * @param[in]
- *   sub : Null terminated C string to search for.
+ * */
+VSTD_INLINE u64 _vstd_hash_read8(const u8 *ptr) {
+  u64 value;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+VSTD_INLINE u64 _vstd_hash_read4(const u8 *ptr) {
+  u32 value;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+VSTD_INLINE u64 _vstd_hash_read3(const u8 *ptr, usize len) {
+  return ((u64)ptr[0] << 16) | ((u64)ptr[len >> 1] << 8) | ptr[len - 1];
+}
+
+/*****************************************************************************
  *
- * @return
- *   Pointer to the start of the substring's first occurrence inside the given
- *   _VSTD_String or a NULL pointer.
+ * @function
+ *   _vstd_hash_block
+ *
+ * @description
+ *   Mixes a 48 byte block into the three lanes of the hash state. This is a
+ *   helper function and it's only meant to be used the vstd library
+ *   functions.
  *
  * */
-VSTD_INLINE char *vstd_string_find_first(const _VSTD_String *string,
-                                         const char *sub);
+VSTD_INLINE void _vstd_hash_block(u64 state[3], const u8 *ptr) {
+  state[0] = _vstd_hash_mix(_vstd_hash_read8(ptr) ^ _VSTD_HASH_SECRET1,
+                            _vstd_hash_read8(ptr + 8) ^ state[0]);
+  state[1] = _vstd_hash_mix(_vstd_hash_read8(ptr + 16) ^ _VSTD_HASH_SECRET2,
+                            _vstd_hash_read8(ptr + 24) ^ state[1]);
+  state[2] = _vstd_hash_mix(_vstd_hash_read8(ptr + 32) ^ _VSTD_HASH_SECRET3,
+                            _vstd_hash_read8(ptr + 40) ^ state[2]);
+}
 
 /*****************************************************************************
  *
  * @function
- *   vstd_string_find_first
+ *   _vstd_hash_tail
  *
  * @description
- *   Tries to find the last occurrence of the substring inside of the given
- *   _VSTD_String. Returns a NULL pointer if it fails.
+ *   Hashes the last 48 or fewer bytes of the input and finalizes the hash.
+ *   When the input was longer than 16 bytes, ptr has to be readable from 16
+ *   bytes before its end. This is a helper function and it's only meant to be
+ *   used the vstd library functions.
  *
  * @param[in]
- *   string : _VSTD_String to search.
+ *   ptr : Remaining bytes.
  * @param[in]
- *   sub : Null terminated C string to search for.
+ *   rem : Number of remaining bytes.
+ * @param[in]
+ *   seed : Hash state.
+ * @param[in]
+ *   len : Length of the whole input.
  *
  * @return
- *   Pointer to the start of the substring's last occurrence inside the given
- *   _VSTD_String or a NULL pointer.
+ *   The hash.
  *
  * */
-VSTD_STATIC char *vstd_string_find_last(const _VSTD_String *string,
-                                        const char *sub);
+VSTD_INLINE u64 _vstd_hash_tail(const u8 *ptr, usize rem, u64 seed, u64 len) {
+  u64 a, b;
+  if (len <= 16) {
+    if (len >= 4) {
+      usize shift = (len >> 3) << 2;
+      a = (_vstd_hash_read4(ptr) << 32) | _vstd_hash_read4(ptr + shift);
+      b = (_vstd_hash_read4(ptr + len - 4) << 32) |
+          _vstd_hash_read4(ptr + len - 4 - shift);
+    } else if (len > 0) {
+      a = _vstd_hash_read3(ptr, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    while (rem > 16) {
+      seed = _vstd_hash_mix(_vstd_hash_read8(ptr) ^ _VSTD_HASH_SECRET1,
+                            _vstd_hash_read8(ptr + 8) ^ seed);
+      ptr += 16;
+      rem -= 16;
+    }
+    a = _vstd_hash_read8(ptr + rem - 16);
+    b = _vstd_hash_read8(ptr + rem - 8);
+  }
+
+  a ^= _VSTD_HASH_SECRET1;
+  b ^= seed;
+  _vstd_hash_mum(&a, &b);
+  return _vstd_hash_mix(a ^ _VSTD_HASH_SECRET0 ^ len, b ^ _VSTD_HASH_SECRET1);
+}
 
 /*****************************************************************************
  *
  * @function
- *   vstd_string_compare
+ *   vstd_hash_bytes
  *
  * @description
- *   Compares the C string with the given _VSTD_String. This function is only
- *   there for API consistency, underlying implementation of this function just
- *   calls strcmp thus, behaviour is identical to that function. For more
- *   information about strcmp you can check:
- *   https://pubs.opengroup.org/onlinepubs/9699919799.2016edition/functions/strcmp.html
+ *   Hashes a byte buffer with the given seed.
  *
  * @param[in]
- *   string : _VSTD_String to compare.
+ *   ptr : Bytes to hash.
  * @param[in]
- *   str : Null terminated C string to be compared with.
+ *   len : Number of bytes.
+ * @param[in]
+ *   seed : Seed of the hash.
  *
  * @return
- *   Integer value indicating the relationship between the two strings.
+ *   The hash.
  *
  * */
-VSTD_INLINE isize vstd_string_compare(const _VSTD_String *string,
-                                      const char *str);
+VSTD_STATIC u64 vstd_hash_bytes(const void *ptr, usize len, u64 seed) {
+  const u8 *p = (const u8 *)ptr;
+  usize rem = len;
+  seed ^= _vstd_hash_mix(seed ^ _VSTD_HASH_SECRET0, _VSTD_HASH_SECRET1);
+
+  if (rem > 48) {
+    u64 state[3] = {seed, seed, seed};
+    do {
+      _vstd_hash_block(state, p);
+      p += 48;
+      rem -= 48;
+    } while (rem > 48);
+    seed = state[0] ^ state[1] ^ state[2];
+  }
+
+  return _vstd_hash_tail(p, rem, seed, len);
+}
 
 /*****************************************************************************
  *
  * @function
- *   vstd_string_free
+ *   vstd_hash_u64
  *
  * @description
- *   Frees the memory allocated for given _VSTD_String's underlying pointer.
+ *   Hashes a single integer with the given seed, with two 128 bit
+ *   multiplications. Every input bit affects every bit of the hash.
  *
  * @param[in]
- *   string : _VSTD_String to free.
+ *   value : Integer to hash.
+ * @param[in]
+ *   seed : Seed of the hash.
+ *
+ * @return
+ *   The hash.
  *
  * */
-VSTD_STATIC void vstd_string_free(_VSTD_String *string);
+VSTD_INLINE u64 vstd_hash_u64(u64 value, u64 seed) {
+  u64 a = value ^ _VSTD_HASH_SECRET0, b = seed ^ _VSTD_HASH_SECRET1;
+  _vstd_hash_mum(&a, &b);
+  return _vstd_hash_mix(a ^ _VSTD_HASH_SECRET0, b ^ _VSTD_HASH_SECRET1);
+}
 
 /*****************************************************************************
  *
- * @function
- *   _vstd_string_realloc
+ * @type:
+ *   _VSTD_Hasher
+ *
+ * @description:
+ *   Streaming state of vstd_hash_bytes, data can be added in pieces and the
+ *   final hash is the same as the hash of the concatenated pieces. Blocks are
+ *   buffered in buf after the last 16 bytes of the previous block, which are
+ *   kept for the tail of the hash.
+ *
+ * */
+struct _VSTD_Hasher {
+  u64 state[3];
+  u64 len;
+  usize count;
+  u8 buf[64];
+};
+
+#ifdef VSTD_HASH_STRIP_PREFIX
+typedef struct _VSTD_Hasher Hasher;
+#define _VSTD_Hasher Hasher
+#else
+typedef struct _VSTD_Hasher VSTD_Hasher;
+#define _VSTD_Hasher VSTD_Hasher
+#endif
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_hasher_new
  *
  * @description
- *   Doubles the given _VSTD_String's capacity and reallocates the underlying
- *   pointer. This is a helper function and it's only meant to be used the vstd
- *   library functions.
+ *   Creates a new _VSTD_Hasher with the given seed.
  *
  * @param[in]
- *   string : _VSTD_String to reallocate.
+ *   seed : Seed of the hash.
+ *
+ * @return
+ *   New _VSTD_Hasher.
  *
  * */
-VSTD_INLINE void _vstd_string_realloc(_VSTD_String *string);
+VSTD_INLINE _VSTD_Hasher vstd_hasher_new(u64 seed) {
+  seed ^= _vstd_hash_mix(seed ^ _VSTD_HASH_SECRET0, _VSTD_HASH_SECRET1);
+  return (_VSTD_Hasher){.state = {seed, seed, seed}, .len = 0, .count = 0};
+}
 
 /*****************************************************************************
  *
- * @section
- *   VSTD String function implementations
+ * @function
+ *   vstd_hasher_update
+ *
+ * @description
+ *   Adds bytes to the hash. A block is only mixed in once more data follows
+ *   it, because the last 48 bytes are hashed by vstd_hasher_finish.
+ *
+ * @param[in]
+ *   hasher : Pointer to _VSTD_Hasher to update.
+ * @param[in]
+ *   ptr : Bytes to add.
+ * @param[in]
+ *   len : Number of bytes.
  *
  * */
+VSTD_STATIC void vstd_hasher_update(_VSTD_Hasher *hasher, const void *ptr,
+                                    usize len) {
+  const u8 *p = (const u8 *)ptr;
+  hasher->len += len;
 
-VSTD_INLINE _VSTD_String vstd_string_new() {
-  return vstd_string_with_capacity(VSTD_STRING_INITIAL_CAP);
-}
-
-VSTD_STATIC _VSTD_String vstd_string_with_capacity(usize cap) {
-  return (_VSTD_String){
-      .ptr = (char *)calloc(cap, sizeof(char)),
-      .cap = cap,
-      .len = 0,
-  };
-}
-
-VSTD_STATIC _VSTD_String vstd_string_from(const char *str) {
-  usize len = strlen(str);
-  _VSTD_String s = vstd_string_with_capacity(len + 1);
-
-  strcpy(s.ptr, str);
-  s.len = len;
+  while (len) {
+    if (hasher->count == 48) {
+      _vstd_hash_block(hasher->state, hasher->buf + 16);
+      memcpy(hasher->buf, hasher->buf + 48, 16);
+      hasher->count = 0;
+    }
+    while (hasher->count == 0 && len > 48) {
+      _vstd_hash_block(hasher->state, p);
+      memcpy(hasher->buf, p + 32, 16);
+      p += 48;
+      len -= 48;
+    }
 
-  return s;
+    usize n = 48 - hasher->count < len ? 48 - hasher->count : len;
+    memcpy(hasher->buf + 16 + hasher->count, p, n);
+    hasher->count += n;
+    p += n;
+    len -= n;
+  }
 }
 
-VSTD_STATIC _VSTD_String vstd_string_clone(const _VSTD_String *string) {
-  _VSTD_String clone = vstd_string_with_capacity(string->cap);
-
-  memcpy(clone.ptr, string->ptr, sizeof(char) * string->len);
-  clone.len = string->len;
-
-  return clone;
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_hasher_finish
+ *
+ * @description
+ *   Returns the hash of the bytes added so far, the hasher isn't modified, so
+ *   more bytes can be added afterwards.
+ *
+ * @param[in]
+ *   hasher : Pointer to _VSTD_Hasher to finish.
+ *
+ * @return
+ *   The hash.
+ *
+ * */
+VSTD_STATIC u64 vstd_hasher_finish(const _VSTD_Hasher *hasher) {
+  u64 seed = hasher->state[0];
+  if (hasher->len > hasher->count) {
+    seed ^= hasher->state[1] ^ hasher->state[2];
+  }
+  return _vstd_hash_tail(hasher->buf + 16, hasher->count, seed, hasher->len);
 }
 
-VSTD_STATIC _VSTD_String vstd_string_format(const char *fmt, ...) {
-  va_list arg_ptr;
-  va_start(arg_ptr, fmt);
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_hash_set_seed
+ *
+ * @description
+ *   Sets the seed used by the predefined vstd_map_hash_* functions, the
+ *   hashes of _VSTD_HStrings and the shards of _VSTD_Interners, which is
+ *   VSTD_HASH_SEED by default. Pass a random value at startup to make the
+ *   hashes unpredictable. The seed is a single weak symbol shared by every
+ *   translation unit, so it has to be set once, before any of these hashes is
+ *   computed, and VSTD_HASH_SEED has to be the same in every file.
+ *
+ * @param[in]
+ *   seed : New seed.
+ *
+ * */
+__attribute__((weak)) u64 _vstd_hash_seed = VSTD_HASH_SEED;
 
-  usize len = vsnprintf(NULL, 0, fmt, arg_ptr);
-  _VSTD_String s = vstd_string_with_capacity(len + 1);
+VSTD_STATIC void vstd_hash_set_seed(u64 seed) { _vstd_hash_seed = seed; }
 
-  vsnprintf(s.ptr, s.cap, fmt, arg_ptr);
-  s.len = len;
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD String
+ *
+ */
 
-  va_end(arg_ptr);
-  return s;
-}
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_String
+ *
+ * @description:
+ *   String implementation, this struct never allocates memory for itself, but
+ *   only for its underlying pointer. When passing an instance of this type, its
+ *   safe to pass it as it is to a function, as long as that function doesn't
+ *   modify the string's pointer or other properties. Otherwise you should pass
+ *   it as a reference, or you may lose the underlying pointer.
+ *
+ *   Strings shorter than VSTD_STRING_INLINE_CAP are stored inline inside the
+ *   struct itself and never allocate, longer strings are moved to the heap. The
+ *   last byte of the struct holds either the length of the inline string, or
+ *   the high byte of the heap capacity with its highest bit set, so the fields
+ *   should never be accessed directly. Use vstd_string_ptr, vstd_string_len and
+ *   vstd_string_cap instead.
+ *
+ *   Strings bound to a _VSTD_Allocator are always stored on the heap, and the
+ *   pointer to their allocator is stored right before their contents. Once
+ *   freed they have no contents left, so the pointer to the allocator is kept
+ *   in place of the pointer to them, and the string stays bound.
+ *
+ * */
+struct _VSTD_String {
+  union {
+    struct {
+      char *ptr;
+      usize len;
+      usize cap;
+    } heap;
+    struct {
+      char buf[sizeof(char *) + sizeof(usize) * 2 - 1];
+      u8 len;
+    } sso;
+  };
+};
 
-VSTD_STATIC _VSTD_String *vstd_string_push(_VSTD_String *string, char c) {
-  if (string->len + 1 >= string->cap) {
-    _vstd_string_realloc(string);
-  }
+#ifdef VSTD_STRING_STRIP_PREFIX
+typedef struct _VSTD_String String;
+#define _VSTD_String String
+#else
+typedef struct _VSTD_String VSTD_String;
+#define _VSTD_String VSTD_String
+#endif
 
-  string->ptr[string->len] = c;
-  string->len++;
+#ifndef VSTD_STRING_INITIAL_CAP
+#define VSTD_STRING_INITIAL_CAP 1
+#endif
 
-  string->ptr[string->len] = '\0';
-  return string;
-}
+#define VSTD_STRING_INLINE_CAP (sizeof(char *) + sizeof(usize) * 2 - 1)
 
-VSTD_STATIC _VSTD_String *vstd_string_push_str(_VSTD_String *string,
-                                               const char *str) {
-  usize len = strlen(str);
+#define VSTD_STRING_EQUAL 0
 
-  while (string->len + len >= string->cap) {
-    _vstd_string_realloc(string);
-  }
+#define _VSTD_STRING_HEAP_BIT 0x80
+#define _VSTD_STRING_BOUND_BIT 0x40
 
-  strcpy(string->ptr + string->len, str);
-  string->len += len;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define _VSTD_STRING_HEAP_CAP(cap, flags) (((usize)(cap) << 8) | (flags))
+#define _VSTD_STRING_CAP(cap) ((usize)(cap) >> 8)
+#else
+#define _VSTD_STRING_HEAP_CAP(cap, flags)                                      \
+  ((usize)(cap) | ((usize)(flags) << (sizeof(usize) * 8 - 8)))
+#define _VSTD_STRING_CAP(cap) ((usize)(cap) & (~(usize)0 >> 8))
+#endif
 
-  string->ptr[string->len] = '\0';
-  return string;
-}
+#define _VSTD_STRING_RELEASED                                                  \
+  _VSTD_STRING_HEAP_CAP(0, _VSTD_STRING_HEAP_BIT | _VSTD_STRING_BOUND_BIT)
 
-VSTD_STATIC _VSTD_String *vstd_string_remove(_VSTD_String *string,
-                                             const char *sub) {
-  if (!sub[0]) {
-    return string;
-  }
+VSTD_STATIC char _vstd_string_empty[1];
 
-  usize len = strlen(sub);
-  char *ptr = strstr(string->ptr, sub);
-  if (!ptr) {
-    return string;
+#define _VSTD_STRING_NULL                                                      \
+  (_VSTD_String) {                                                             \
+    .heap = {.ptr = NULL,                                                      \
+             .len = 0,                                                         \
+             .cap = _VSTD_STRING_HEAP_CAP(0, _VSTD_STRING_HEAP_BIT) }          \
   }
 
-  return vstd_string_remove_at(string, (usize)(ptr - string->ptr), len);
-}
-
-VSTD_STATIC _VSTD_String *vstd_string_remove_at(_VSTD_String *string,
-                                                usize index, usize len) {
-  usize move_size = string->len - (index + len);
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD String function declarations
+ *
+ * */
 
-  if (move_size > 0) {
-    memmove(string->ptr + index, string->ptr + index + len, move_size);
-  }
-  string->len -= len;
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_new
+ *
+ * @description
+ *   Creates a new empty _VSTD_String object, this function internally calls
+ *   vstd_string_with_capacity with VSTD_STRING_INITIAL_CAP as the argument.
+ *
+ * @return
+ *   New empty _VSTD_String with capacity of VSTD_STRING_INITIAL_CAP.
+ *
+ * */
+VSTD_INLINE _VSTD_String vstd_string_new();
 
-  string->ptr[string->len] = '\0';
-  return string;
-}
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_with_capacity
+ *
+ * @description
+ *   Creates a new empty _VSTD_String object with the given capacity. If the
+ *   capacity fits in VSTD_STRING_INLINE_CAP no memory is allocated.
+ *
+ * @param[in]
+ *   cap : Capacity for the new _VSTD_String.
+ *
+ * @return
+ *   New empty _VSTD_String with given capacity.
+ *
+ * */
+VSTD_STATIC _VSTD_String vstd_string_with_capacity(usize cap);
 
-VSTD_INLINE char *vstd_string_find_first(const _VSTD_String *string,
-                                         const char *sub) {
-  return strstr(string->ptr, sub);
-}
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_with_allocator
+ *
+ * @description
+ *   Creates a new empty _VSTD_String object with the given capacity, which is
+ *   bound to the allocator. Every reallocation of the string, and of its clones
+ *   is made from the same allocator. If the allocator is NULL this function is
+ *   identical to vstd_string_with_capacity.
+ *
+ * @param[in]
+ *   cap : Capacity for the new _VSTD_String.
+ * @param[in]
+ *   allocator : _VSTD_Allocator to bind the _VSTD_String to.
+ *
+ * @return
+ *   New empty _VSTD_String with given capacity.
+ *
+ * */
+VSTD_STATIC _VSTD_String
+vstd_string_with_allocator(usize cap, const _VSTD_Allocator *allocator);
 
-VSTD_STATIC char *vstd_string_find_last(const _VSTD_String *string,
-                                        const char *sub) {
-  if (!sub[0]) {
-    return NULL;
-  }
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_from
+ *
+ * @description
+ *   Creates a new null terminated _VSTD_String from given C string.
+ *
+ * @param[in]
+ *   str : Null terminated C string to copy from.
+ *
+ * @return
+ *   New null terminated _VSTD_String with the same contents as the given C
+ *   string.
+ *
+ * */
+VSTD_STATIC _VSTD_String vstd_string_from(const char *str);
 
-  char *pos = NULL;
-  for (char *ptr = string->ptr; (ptr = strstr(ptr, sub)) != NULL; ptr += 1) {
-    pos = ptr;
-  }
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_clone
+ *
+ * @description
+ *   Clones the given _VSTD_String and returns the clone.
+ *
+ * @param[in]
+ *   string : _VSTD_String to clone.
+ *
+ * @return
+ *   New _VSTD_String identical to the given _VSTD_String.
+ *
+ * */
+VSTD_STATIC _VSTD_String vstd_string_clone(const _VSTD_String *string);
 
-  return pos;
-}
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_format
+ *
+ * @description
+ *   Creates a new _VSTD_String using the formatted contents.
+ *
+ * @param[in]
+ *   fmt : Null terminated C string specifying how to interpret the data.
+ * @param[in]
+ *   ... : Arguments specifying the data to format.
+ *
+ * @return
+ *   New _VSTD_String with the formatted contents.
+ *
+ * */
+VSTD_STATIC _VSTD_String vstd_string_format(const char *fmt, ...);
 
-VSTD_INLINE isize vstd_string_compare(const _VSTD_String *string,
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_ptr
+ *
+ * @description
+ *   Returns the pointer to the null terminated contents of the _VSTD_String,
+ *   which either points to the inline buffer or to the heap. The pointer is
+ *   invalidated by any function that modifies the _VSTD_String, and the inline
+ *   buffer moves with the struct when it's copied.
+ *
+ * @param[in]
+ *   string : _VSTD_String to access.
+ *
+ * @return
+ *   Pointer to the contents of the _VSTD_String.
+ *
+ * */
+VSTD_INLINE char *vstd_string_ptr(const _VSTD_String *string);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_len
+ *
+ * @description
+ *   Returns the length of the _VSTD_String, excluding the null terminator.
+ *
+ * @param[in]
+ *   string : _VSTD_String to access.
+ *
+ * @return
+ *   Length of the _VSTD_String.
+ *
+ * */
+VSTD_INLINE usize vstd_string_len(const _VSTD_String *string);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_cap
+ *
+ * @description
+ *   Returns the capacity of the _VSTD_String, including the space for the null
+ *   terminator. For inline strings this is VSTD_STRING_INLINE_CAP.
+ *
+ * @param[in]
+ *   string : _VSTD_String to access.
+ *
+ * @return
+ *   Capacity of the _VSTD_String.
+ *
+ * */
+VSTD_INLINE usize vstd_string_cap(const _VSTD_String *string);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_allocator
+ *
+ * @description
+ *   Returns the _VSTD_Allocator the _VSTD_String is bound to.
+ *
+ * @param[in]
+ *   string : _VSTD_String to access.
+ *
+ * @return
+ *   Pointer to the _VSTD_Allocator, or NULL if the string uses the heap.
+ *
+ * */
+VSTD_INLINE const _VSTD_Allocator *
+vstd_string_allocator(const _VSTD_String *string);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_push
+ *
+ * @description
+ *   Adds a character to the end of given _VSTD_String, this function may resize
+ *   the supplied _VSTD_String.
+ *
+ * @param[in]
+ *   string : _VSTD_String to modify.
+ * @param[in]
+ *   c : Character to push.
+ *
+ * @return
+ *   Pointer to same modified _VSTD_String.
+ *
+ * */
+VSTD_STATIC _VSTD_String *vstd_string_push(_VSTD_String *string, char c);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_push_str
+ *
+ * @description
+ *   Adds the C string to the end of given _VSTD_String, this function
+ *   may resize the given _VSTD_String.
+ *
+ * @param[in]
+ *   string : _VSTD_String to modify.
+ * @param[in]
+ *   str : Null terminated C string to push.
+ *
+ * @return
+ *   Pointer to same modified _VSTD_String.
+ *
+ * */
+VSTD_STATIC _VSTD_String *vstd_string_push_str(_VSTD_String *string,
+                                               const char *str);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_remove
+ *
+ * @description
+ *   Tries to remove a substring from the given _VSTD_String if it's present in
+ *   it. Only removes the first occurrence of the substring.
+ *
+ * @param[in]
+ *   string : _VSTD_String to modify.
+ * @param[in]
+ *   sub : Null terminated C string to remove.
+ *
+ * @return
+ *   Pointer to same _VSTD_String, it may or may not be modified depending on
+ *   whether or not the given C string is present in it.
+ *
+ * */
+VSTD_STATIC _VSTD_String *vstd_string_remove(_VSTD_String *string,
+                                             const char *sub);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_remove_at
+ *
+ * @description
+ *   Removes n number of characters starting from the index from the given
+ *   _VSTD_String.
+ *
+ * @param[in]
+ *   string : _VSTD_String to modify.
+ * @param[in]
+ *   index : Starting index for removal.
+ * @param[in]
+ *   len : Number of characters to remove.
+ *
+ * @return
+ *   Pointer to same modified _VSTD_String.
+ *
+ * */
+VSTD_STATIC _VSTD_String *vstd_string_remove_at(_VSTD_String *string,
+                                                usize index, usize len);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_replace_all
+ *
+ * @description
+ *   Replaces every non-overlapping occurrence of the substring inside of the
+ *   given _VSTD_String with the replacement. If the replacement is not longer
+ *   than the substring, the string is compacted in place in a single pass,
+ *   otherwise the occurrences are counted first and the result is built in one
+ *   pass into a buffer allocated with the exact size.
+ *
+ * @param[in]
+ *   string : _VSTD_String to modify.
+ * @param[in]
+ *   sub : Null terminated C string to replace.
+ * @param[in]
+ *   rep : Null terminated C string to replace with.
+ *
+ * @return
+ *   Number of replaced occurrences.
+ *
+ * */
+VSTD_STATIC usize vstd_string_replace_all(_VSTD_String *string,
+                                          const char *sub, const char *rep);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_remove_all
+ *
+ * @description
+ *   Removes every non-overlapping occurrence of the substring from the given
+ *   _VSTD_String in a single pass, this function never reallocates.
+ *
+ * @param[in]
+ *   string : _VSTD_String to modify.
+ * @param[in]
+ *   sub : Null terminated C string to remove.
+ *
+ * @return
+ *   Number of removed occurrences.
+ *
+ * */
+VSTD_INLINE usize vstd_string_remove_all(_VSTD_String *string,
+                                         const char *sub);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_find_first
+ *
+ * @description
+ *   Tries to find the first occurrence of the substring inside of the given
+ *   _VSTD_String. The search is bounded by the _VSTD_String's length rather
+ *   than its null terminator, so the string may contain null characters.
+ *   Returns a NULL pointer if it fails.
+ *
+ * @param[in]
+ *   string : _VSTD_String to search.
+ * @param[in]
+ *   sub : Null terminated C string to search for.
+ *
+ * @return
+ *   Pointer to the start of the substring's first occurrence inside the given
+ *   _VSTD_String or a NULL pointer.
+ *
+ * */
+VSTD_INLINE char *vstd_string_find_first(const _VSTD_String *string,
+                                         const char *sub);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_find_last
+ *
+ * @description
+ *   Tries to find the last occurrence of the substring inside of the given
+ *   _VSTD_String, by searching it backwards from its end. Returns a NULL
+ *   pointer if it fails.
+ *
+ * @param[in]
+ *   string : _VSTD_String to search.
+ * @param[in]
+ *   sub : Null terminated C string to search for.
+ *
+ * @return
+ *   Pointer to the start of the substring's last occurrence inside the given
+ *   _VSTD_String or a NULL pointer.
+ *
+ * */
+VSTD_STATIC char *vstd_string_find_last(const _VSTD_String *string,
+                                        const char *sub);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_compare
+ *
+ * @description
+ *   Compares the C string with the given _VSTD_String. This function is only
+ *   there for API consistency, underlying implementation of this function just
+ *   calls strcmp thus, behaviour is identical to that function. For more
+ *   information about strcmp you can check:
+ *   https://pubs.opengroup.org/onlinepubs/9699919799.2016edition/functions/strcmp.html
+ *
+ * @param[in]
+ *   string : _VSTD_String to compare.
+ * @param[in]
+ *   str : Null terminated C string to be compared with.
+ *
+ * @return
+ *   Integer value indicating the relationship between the two strings.
+ *
+ * */
+VSTD_INLINE isize vstd_string_compare(const _VSTD_String *string,
+                                      const char *str);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_string_free
+ *
+ * @description
+ *   Frees the memory allocated for given _VSTD_String's underlying pointer, if
+ *   it has one, and resets it to an empty _VSTD_String. A string bound to an
+ *   allocator stays bound, so it can be reused and it allocates from the same
+ *   allocator again.
+ *
+ * @param[in]
+ *   string : _VSTD_String to free.
+ *
+ * */
+VSTD_STATIC void vstd_string_free(_VSTD_String *string);
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_string_realloc
+ *
+ * @description
+ *   Doubles the given _VSTD_String's capacity and reallocates the underlying
+ *   pointer. This is a helper function and it's only meant to be used the vstd
+ *   library functions.
+ *
+ * @param[in]
+ *   string : _VSTD_String to reallocate.
+ *
+ * */
+VSTD_INLINE void _vstd_string_realloc(_VSTD_String *string);
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_string_reserve
+ *
+ * @description
+ *   Doubles the given _VSTD_String's capacity until it's at least cap, and
+ *   reallocates the underlying pointer once. Inline strings are moved to the
+ *   heap. This is a helper function and it's only meant to be used the vstd
+ *   library functions.
+ *
+ * @param[in]
+ *   string : _VSTD_String to reallocate.
+ * @param[in]
+ *   cap : Minimum capacity required.
+ *
+ * */
+VSTD_STATIC void _vstd_string_reserve(_VSTD_String *string, usize cap);
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_string_set_len
+ *
+ * @description
+ *   Sets the length of the given _VSTD_String, without touching its contents.
+ *   This is a helper function and it's only meant to be used the vstd library
+ *   functions.
+ *
+ * @param[in]
+ *   string : _VSTD_String to modify.
+ * @param[in]
+ *   len : New length.
+ *
+ * */
+VSTD_INLINE void _vstd_string_set_len(_VSTD_String *string, usize len);
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD String function implementations
+ *
+ * */
+
+VSTD_INLINE _VSTD_String vstd_string_new() {
+  return vstd_string_with_capacity(VSTD_STRING_INITIAL_CAP);
+}
+
+VSTD_STATIC _VSTD_String vstd_string_with_capacity(usize cap) {
+  _VSTD_String s = (_VSTD_String){};
+
+  if (cap > VSTD_STRING_INLINE_CAP) {
+    s.heap.ptr = (char *)VSTD_CALLOC(cap, sizeof(char));
+    s.heap.len = 0;
+    s.heap.cap = _VSTD_STRING_HEAP_CAP(cap, _VSTD_STRING_HEAP_BIT);
+  }
+
+  return s;
+}
+
+VSTD_STATIC _VSTD_String
+vstd_string_with_allocator(usize cap, const _VSTD_Allocator *allocator) {
+  if (!allocator) {
+    return vstd_string_with_capacity(cap);
+  }
+  if (!cap) {
+    cap = 1;
+  }
+
+  usize header = sizeof(const _VSTD_Allocator *);
+  char *block = (char *)vstd_alloc(allocator, header + sizeof(char) * cap);
+  memcpy(block, &allocator, header);
+
+  _VSTD_String s;
+  s.heap.ptr = block + header;
+  s.heap.ptr[0] = '\0';
+  s.heap.len = 0;
+  s.heap.cap = _VSTD_STRING_HEAP_CAP(
+      cap, _VSTD_STRING_HEAP_BIT | _VSTD_STRING_BOUND_BIT);
+
+  return s;
+}
+
+VSTD_STATIC _VSTD_String vstd_string_from(const char *str) {
+  usize len = strlen(str);
+  _VSTD_String s = vstd_string_with_capacity(len + 1);
+
+  memcpy(vstd_string_ptr(&s), str, sizeof(char) * (len + 1));
+  _vstd_string_set_len(&s, len);
+
+  return s;
+}
+
+VSTD_STATIC _VSTD_String vstd_string_clone(const _VSTD_String *string) {
+  usize len = vstd_string_len(string);
+  _VSTD_String clone =
+      vstd_string_with_allocator(len + 1, vstd_string_allocator(string));
+
+  char *ptr = vstd_string_ptr(&clone);
+  memcpy(ptr, vstd_string_ptr(string), sizeof(char) * len);
+  ptr[len] = '\0';
+  _vstd_string_set_len(&clone, len);
+
+  return clone;
+}
+
+VSTD_STATIC _VSTD_String vstd_string_format(const char *fmt, ...) {
+  va_list arg_ptr, arg_copy;
+  va_start(arg_ptr, fmt);
+  va_copy(arg_copy, arg_ptr);
+
+  usize len = vsnprintf(NULL, 0, fmt, arg_copy);
+  _VSTD_String s = vstd_string_with_capacity(len + 1);
+
+  vsnprintf(vstd_string_ptr(&s), len + 1, fmt, arg_ptr);
+  _vstd_string_set_len(&s, len);
+
+  va_end(arg_copy);
+  va_end(arg_ptr);
+  return s;
+}
+
+VSTD_INLINE char *vstd_string_ptr(const _VSTD_String *string) {
+  if (string->sso.len & _VSTD_STRING_HEAP_BIT) {
+    if (string->heap.cap == _VSTD_STRING_RELEASED) {
+      return _vstd_string_empty;
+    }
+    return string->heap.ptr;
+  }
+  return (char *)string->sso.buf;
+}
+
+VSTD_INLINE usize vstd_string_len(const _VSTD_String *string) {
+  if (string->sso.len & _VSTD_STRING_HEAP_BIT) {
+    return string->heap.len;
+  }
+  return string->sso.len;
+}
+
+VSTD_INLINE usize vstd_string_cap(const _VSTD_String *string) {
+  if (string->sso.len & _VSTD_STRING_HEAP_BIT) {
+    return _VSTD_STRING_CAP(string->heap.cap);
+  }
+  return VSTD_STRING_INLINE_CAP;
+}
+
+VSTD_INLINE const _VSTD_Allocator *
+vstd_string_allocator(const _VSTD_String *string) {
+  const u8 bound = _VSTD_STRING_HEAP_BIT | _VSTD_STRING_BOUND_BIT;
+  if ((string->sso.len & bound) != bound) {
+    return NULL;
+  }
+  if (string->heap.cap == _VSTD_STRING_RELEASED) {
+    return (const _VSTD_Allocator *)string->heap.ptr;
+  }
+
+  const _VSTD_Allocator *allocator;
+  memcpy(&allocator, string->heap.ptr - sizeof(allocator), sizeof(allocator));
+  return allocator;
+}
+
+VSTD_STATIC _VSTD_String *vstd_string_push(_VSTD_String *string, char c) {
+  usize len = vstd_string_len(string);
+
+  if (len + 1 >= vstd_string_cap(string)) {
+    _vstd_string_realloc(string);
+  }
+
+  char *ptr = vstd_string_ptr(string);
+  ptr[len] = c;
+  ptr[len + 1] = '\0';
+
+  _vstd_string_set_len(string, len + 1);
+  return string;
+}
+
+VSTD_STATIC _VSTD_String *vstd_string_push_str(_VSTD_String *string,
+                                               const char *str) {
+  usize len = strlen(str);
+  usize old_len = vstd_string_len(string);
+
+  if (old_len + len >= vstd_string_cap(string)) {
+    _vstd_string_reserve(string, old_len + len + 1);
+  }
+
+  memcpy(vstd_string_ptr(string) + old_len, str, sizeof(char) * (len + 1));
+
+  _vstd_string_set_len(string, old_len + len);
+  return string;
+}
+
+VSTD_STATIC _VSTD_String *vstd_string_remove(_VSTD_String *string,
+                                             const char *sub) {
+  if (!sub[0]) {
+    return string;
+  }
+
+  usize len = strlen(sub);
+  const char *ptr = vstd_string_ptr(string);
+  const char *pos = _vstd_mem_find(ptr, vstd_string_len(string), sub, len);
+  if (!pos) {
+    return string;
+  }
+
+  return vstd_string_remove_at(string, (usize)(pos - ptr), len);
+}
+
+VSTD_STATIC _VSTD_String *vstd_string_remove_at(_VSTD_String *string,
+                                                usize index, usize len) {
+  char *ptr = vstd_string_ptr(string);
+  usize move_size = vstd_string_len(string) - (index + len);
+
+  if (move_size > 0) {
+    memmove(ptr + index, ptr + index + len, move_size);
+  }
+  _vstd_string_set_len(string, vstd_string_len(string) - len);
+
+  ptr[vstd_string_len(string)] = '\0';
+  return string;
+}
+
+VSTD_STATIC usize vstd_string_replace_all(_VSTD_String *string,
+                                          const char *sub, const char *rep) {
+  usize sub_len = strlen(sub);
+  usize rep_len = strlen(rep);
+  if (!sub_len) {
+    return 0;
+  }
+
+  char *ptr = vstd_string_ptr(string);
+  const char *end = ptr + vstd_string_len(string);
+  const char *read = ptr;
+  const char *pos;
+  usize count = 0;
+
+  if (rep_len <= sub_len) {
+    char *write = ptr;
+    while ((pos = _vstd_mem_find(read, end - read, sub, sub_len)) != NULL) {
+      if (write != read) {
+        memmove(write, read, pos - read);
+      }
+      write += pos - read;
+      memcpy(write, rep, rep_len);
+      write += rep_len;
+      read = pos + sub_len;
+      count++;
+    }
+
+    if (count) {
+      memmove(write, read, end - read);
+      write += end - read;
+      *write = '\0';
+      _vstd_string_set_len(string, (usize)(write - ptr));
+    }
+    return count;
+  }
+
+  while ((pos = _vstd_mem_find(read, end - read, sub, sub_len)) != NULL) {
+    read = pos + sub_len;
+    count++;
+  }
+  if (!count) {
+    return count;
+  }
+
+  usize len = (usize)(end - ptr) + count * (rep_len - sub_len);
+  _VSTD_String out =
+      vstd_string_with_allocator(len + 1, vstd_string_allocator(string));
+  char *write = vstd_string_ptr(&out);
+
+  read = ptr;
+  for (usize i = 0; i < count; ++i) {
+    pos = _vstd_mem_find(read, end - read, sub, sub_len);
+    memcpy(write, read, pos - read);
+    write += pos - read;
+    memcpy(write, rep, rep_len);
+    write += rep_len;
+    read = pos + sub_len;
+  }
+  memcpy(write, read, end - read);
+  write[end - read] = '\0';
+  _vstd_string_set_len(&out, len);
+
+  vstd_string_free(string);
+  *string = out;
+
+  return count;
+}
+
+VSTD_INLINE usize vstd_string_remove_all(_VSTD_String *string,
+                                         const char *sub) {
+  return vstd_string_replace_all(string, sub, "");
+}
+
+VSTD_INLINE char *vstd_string_find_first(const _VSTD_String *string,
+                                         const char *sub) {
+  return (char *)_vstd_mem_find(vstd_string_ptr(string),
+                                vstd_string_len(string), sub, strlen(sub));
+}
+
+VSTD_STATIC char *vstd_string_find_last(const _VSTD_String *string,
+                                        const char *sub) {
+  if (!sub[0]) {
+    return NULL;
+  }
+
+  return (char *)_vstd_mem_find_last(vstd_string_ptr(string),
+                                     vstd_string_len(string), sub, strlen(sub));
+}
+
+VSTD_INLINE isize vstd_string_compare(const _VSTD_String *string,
                                       const char *str) {
-  return strcmp(string->ptr, str);
+  return strcmp(vstd_string_ptr(string), str);
+}
+
+VSTD_STATIC void vstd_string_free(_VSTD_String *string) {
+  const _VSTD_Allocator *allocator = vstd_string_allocator(string);
+
+  if (allocator) {
+    if (string->heap.cap != _VSTD_STRING_RELEASED) {
+      usize header = sizeof(allocator);
+      vstd_free(allocator, string->heap.ptr - header,
+                header + vstd_string_cap(string));
+    }
+    string->heap.ptr = (char *)allocator;
+    string->heap.len = 0;
+    string->heap.cap = _VSTD_STRING_RELEASED;
+    return;
+  }
+
+  if (string->sso.len & _VSTD_STRING_HEAP_BIT) {
+    VSTD_FREE(string->heap.ptr);
+  }
+
+  *string = (_VSTD_String){};
+}
+
+VSTD_INLINE void _vstd_string_realloc(_VSTD_String *string) {
+  _vstd_string_reserve(string, vstd_string_cap(string) + 1);
+}
+
+VSTD_STATIC void _vstd_string_reserve(_VSTD_String *string, usize cap) {
+  usize new_cap = vstd_string_cap(string);
+  if (new_cap >= cap) {
+    return;
+  }
+
+  if (new_cap == 0) {
+    new_cap = VSTD_STRING_INLINE_CAP;
+  }
+  while (new_cap < cap) {
+    new_cap *= 2;
+  }
+
+  const _VSTD_Allocator *allocator = vstd_string_allocator(string);
+  u8 flags = string->sso.len;
+
+  if (allocator && string->heap.cap == _VSTD_STRING_RELEASED) {
+    *string = vstd_string_with_allocator(new_cap, allocator);
+    return;
+  }
+
+  if (allocator) {
+    usize header = sizeof(allocator);
+    char *block = (char *)vstd_realloc(
+        allocator, string->heap.ptr - header,
+        header + vstd_string_cap(string), header + sizeof(char) * new_cap);
+    string->heap.ptr = block + header;
+    string->heap.cap = _VSTD_STRING_HEAP_CAP(new_cap, flags);
+    return;
+  }
+
+  if (flags & _VSTD_STRING_HEAP_BIT) {
+    string->heap.ptr =
+        (char *)VSTD_REALLOC(string->heap.ptr, sizeof(char) * new_cap);
+    string->heap.cap = _VSTD_STRING_HEAP_CAP(new_cap, flags);
+    return;
+  }
+
+  usize len = string->sso.len;
+  char *ptr = (char *)VSTD_MALLOC(sizeof(char) * new_cap);
+  memcpy(ptr, string->sso.buf, sizeof(char) * (len + 1));
+
+  string->heap.ptr = ptr;
+  string->heap.len = len;
+  string->heap.cap = _VSTD_STRING_HEAP_CAP(new_cap, _VSTD_STRING_HEAP_BIT);
+}
+
+VSTD_INLINE void _vstd_string_set_len(_VSTD_String *string, usize len) {
+  if (string->sso.len & _VSTD_STRING_HEAP_BIT) {
+    string->heap.len = len;
+  } else {
+    string->sso.len = (u8)len;
+  }
+}
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD StrView
+ *
+ * */
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_StrView
+ *
+ * @description:
+ *   Non-owning view into a sequence of characters, which is not necessarily
+ *   null terminated. It never allocates or frees any memory, so it's only valid
+ *   as long as the memory it points to is valid and unmodified. Views of a
+ *   _VSTD_String are invalidated by any function that modifies the string.
+ *
+ * */
+struct _VSTD_StrView {
+  const char *ptr;
+  usize len;
+};
+
+#ifdef VSTD_STRVIEW_STRIP_PREFIX
+typedef struct _VSTD_StrView StrView;
+#define _VSTD_StrView StrView
+#else
+typedef struct _VSTD_StrView VSTD_StrView;
+#define _VSTD_StrView VSTD_StrView
+#endif
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_StrSplit
+ *
+ * @description:
+ *   Lazy split iterator over a _VSTD_StrView, every call to
+ *   vstd_strview_split_next yields the next field without allocating.
+ *
+ * */
+struct _VSTD_StrSplit {
+  _VSTD_StrView rest;
+  const char *delim;
+  usize delim_len;
+  bool done;
+};
+
+#ifdef VSTD_STRVIEW_STRIP_PREFIX
+typedef struct _VSTD_StrSplit StrSplit;
+#define _VSTD_StrSplit StrSplit
+#else
+typedef struct _VSTD_StrSplit VSTD_StrSplit;
+#define _VSTD_StrSplit VSTD_StrSplit
+#endif
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD StrView function declarations
+ *
+ * */
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_new
+ *
+ * @description
+ *   Creates a new _VSTD_StrView from the pointer and the length.
+ *
+ * @param[in]
+ *   ptr : Pointer to the first character.
+ * @param[in]
+ *   len : Number of characters.
+ *
+ * @return
+ *   New _VSTD_StrView.
+ *
+ * */
+VSTD_INLINE _VSTD_StrView vstd_strview_new(const char *ptr, usize len);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_from
+ *
+ * @description
+ *   Creates a new _VSTD_StrView of the given C string, excluding its null
+ *   terminator.
+ *
+ * @param[in]
+ *   str : Null terminated C string to view.
+ *
+ * @return
+ *   New _VSTD_StrView.
+ *
+ * */
+VSTD_INLINE _VSTD_StrView vstd_strview_from(const char *str);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_from_string
+ *
+ * @description
+ *   Creates a new _VSTD_StrView of the whole _VSTD_String.
+ *
+ * @param[in]
+ *   string : _VSTD_String to view.
+ *
+ * @return
+ *   New _VSTD_StrView.
+ *
+ * */
+VSTD_INLINE _VSTD_StrView vstd_strview_from_string(const _VSTD_String *string);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_to_string
+ *
+ * @description
+ *   Copies the contents of the _VSTD_StrView into a new null terminated
+ *   _VSTD_String.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to copy.
+ *
+ * @return
+ *   New _VSTD_String with the same contents as the _VSTD_StrView.
+ *
+ * */
+VSTD_STATIC _VSTD_String vstd_strview_to_string(_VSTD_StrView view);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_slice
+ *
+ * @description
+ *   Returns the part of the _VSTD_StrView starting from the index with the
+ *   given length. Both the index and the length are clamped to the view.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to slice.
+ * @param[in]
+ *   index : Starting index of the slice.
+ * @param[in]
+ *   len : Length of the slice.
+ *
+ * @return
+ *   New _VSTD_StrView into the same memory.
+ *
+ * */
+VSTD_INLINE _VSTD_StrView vstd_strview_slice(_VSTD_StrView view, usize index,
+                                             usize len);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_find
+ *
+ * @description
+ *   Tries to find the first occurrence of the substring inside of the given
+ *   _VSTD_StrView. Returns a NULL pointer if it fails.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to search.
+ * @param[in]
+ *   sub : Null terminated C string to search for.
+ *
+ * @return
+ *   Pointer to the start of the substring's first occurrence inside the given
+ *   _VSTD_StrView or a NULL pointer.
+ *
+ * */
+VSTD_STATIC const char *vstd_strview_find(_VSTD_StrView view, const char *sub);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_find_char
+ *
+ * @description
+ *   Tries to find the first occurrence of the character inside of the given
+ *   _VSTD_StrView. Returns a NULL pointer if it fails.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to search.
+ * @param[in]
+ *   c : Character to search for.
+ *
+ * @return
+ *   Pointer to the character's first occurrence inside the given _VSTD_StrView
+ *   or a NULL pointer.
+ *
+ * */
+VSTD_INLINE const char *vstd_strview_find_char(_VSTD_StrView view, char c);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_split_once
+ *
+ * @description
+ *   Splits the _VSTD_StrView at the first occurrence of the delimiter. If the
+ *   delimiter isn't present, head is set to the whole view and tail is set to
+ *   an empty view.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to split.
+ * @param[in]
+ *   delim : Null terminated C string to split at.
+ * @param[out]
+ *   head : Part of the view before the delimiter.
+ * @param[out]
+ *   tail : Part of the view after the delimiter.
+ *
+ * @return
+ *   Whether or not the delimiter is present in the _VSTD_StrView.
+ *
+ * */
+VSTD_STATIC bool vstd_strview_split_once(_VSTD_StrView view, const char *delim,
+                                         _VSTD_StrView *head,
+                                         _VSTD_StrView *tail);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_split
+ *
+ * @description
+ *   Creates a lazy split iterator over the _VSTD_StrView. Empty fields between
+ *   consecutive delimiters are yielded as empty views.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to split.
+ * @param[in]
+ *   delim : Null terminated C string to split at, must not be empty.
+ *
+ * @return
+ *   New _VSTD_StrSplit iterator.
+ *
+ * */
+VSTD_INLINE _VSTD_StrSplit vstd_strview_split(_VSTD_StrView view,
+                                              const char *delim);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_split_next
+ *
+ * @description
+ *   Advances the split iterator and stores the next field in out.
+ *
+ * @param[in]
+ *   split : _VSTD_StrSplit iterator to advance.
+ * @param[out]
+ *   out : Next field of the split.
+ *
+ * @return
+ *   False if there are no fields left, true otherwise.
+ *
+ * */
+VSTD_STATIC bool vstd_strview_split_next(_VSTD_StrSplit *split,
+                                         _VSTD_StrView *out);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_trim
+ *
+ * @description
+ *   Returns the _VSTD_StrView without its leading and trailing whitespace.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to trim.
+ *
+ * @return
+ *   Trimmed _VSTD_StrView into the same memory.
+ *
+ * */
+VSTD_INLINE _VSTD_StrView vstd_strview_trim(_VSTD_StrView view);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_trim_left
+ *
+ * @description
+ *   Returns the _VSTD_StrView without its leading whitespace.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to trim.
+ *
+ * @return
+ *   Trimmed _VSTD_StrView into the same memory.
+ *
+ * */
+VSTD_STATIC _VSTD_StrView vstd_strview_trim_left(_VSTD_StrView view);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_trim_right
+ *
+ * @description
+ *   Returns the _VSTD_StrView without its trailing whitespace.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to trim.
+ *
+ * @return
+ *   Trimmed _VSTD_StrView into the same memory.
+ *
+ * */
+VSTD_STATIC _VSTD_StrView vstd_strview_trim_right(_VSTD_StrView view);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_starts_with
+ *
+ * @description
+ *   Checks whether or not the _VSTD_StrView starts with the prefix.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to check.
+ * @param[in]
+ *   prefix : Null terminated C string to check for.
+ *
+ * @return
+ *   True if the view starts with the prefix, false otherwise.
+ *
+ * */
+VSTD_INLINE bool vstd_strview_starts_with(_VSTD_StrView view,
+                                          const char *prefix);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_ends_with
+ *
+ * @description
+ *   Checks whether or not the _VSTD_StrView ends with the suffix.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to check.
+ * @param[in]
+ *   suffix : Null terminated C string to check for.
+ *
+ * @return
+ *   True if the view ends with the suffix, false otherwise.
+ *
+ * */
+VSTD_INLINE bool vstd_strview_ends_with(_VSTD_StrView view,
+                                        const char *suffix);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_compare
+ *
+ * @description
+ *   Lexicographically compares two _VSTD_StrViews, a view that is a prefix of
+ *   the other one compares as smaller.
+ *
+ * @param[in]
+ *   a : _VSTD_StrView to compare.
+ * @param[in]
+ *   b : _VSTD_StrView to be compared with.
+ *
+ * @return
+ *   Integer value indicating the relationship between the two views, which is
+ *   VSTD_STRING_EQUAL if they're equal.
+ *
+ * */
+VSTD_STATIC isize vstd_strview_compare(_VSTD_StrView a, _VSTD_StrView b);
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_strview_equal
+ *
+ * @description
+ *   Checks whether or not two _VSTD_StrViews have the same contents, lengths
+ *   are compared before the contents.
+ *
+ * @param[in]
+ *   a : _VSTD_StrView to compare.
+ * @param[in]
+ *   b : _VSTD_StrView to be compared with.
+ *
+ * @return
+ *   True if the views are equal, false otherwise.
+ *
+ * */
+VSTD_INLINE bool vstd_strview_equal(_VSTD_StrView a, _VSTD_StrView b);
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_strview_split_iter
+ *
+ * @description
+ *   Helper function to easily iterate trough the fields of a _VSTD_StrView
+ *   split at the delimiter. In every iteration it is possible to access the
+ *   current field as a _VSTD_StrView from _$iter and current index from _$i.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to split.
+ * @param[in]
+ *   delim : Null terminated C string to split at, must not be empty.
+ * @param[in]
+ *   ... : A single function or a block of code to execute every iteration.
+ *
+ * */
+#define vstd_strview_split_iter(view, delim, ...)                              \
+  do {                                                                         \
+    _VSTD_StrSplit _split = vstd_strview_split(view, delim);                   \
+    _VSTD_StrView _$iter;                                                      \
+    for (usize _$i = 0; vstd_strview_split_next(&_split, &_$iter); ++_$i) {    \
+      __VA_ARGS__;                                                             \
+      (void)(_$i);                                                             \
+      (void)(_$iter);                                                          \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD StrView function implementations
+ *
+ * */
+
+VSTD_INLINE _VSTD_StrView vstd_strview_new(const char *ptr, usize len) {
+  return (_VSTD_StrView){.ptr = ptr, .len = len};
+}
+
+VSTD_INLINE _VSTD_StrView vstd_strview_from(const char *str) {
+  return (_VSTD_StrView){.ptr = str, .len = strlen(str)};
+}
+
+VSTD_INLINE _VSTD_StrView vstd_strview_from_string(const _VSTD_String *string) {
+  return (_VSTD_StrView){
+      .ptr = vstd_string_ptr(string),
+      .len = vstd_string_len(string),
+  };
+}
+
+VSTD_STATIC _VSTD_String vstd_strview_to_string(_VSTD_StrView view) {
+  _VSTD_String s = vstd_string_with_capacity(view.len + 1);
+
+  char *ptr = vstd_string_ptr(&s);
+  memcpy(ptr, view.ptr, sizeof(char) * view.len);
+  ptr[view.len] = '\0';
+  _vstd_string_set_len(&s, view.len);
+
+  return s;
+}
+
+VSTD_INLINE _VSTD_StrView vstd_strview_slice(_VSTD_StrView view, usize index,
+                                             usize len) {
+  if (index > view.len) {
+    index = view.len;
+  }
+  if (len > view.len - index) {
+    len = view.len - index;
+  }
+
+  return (_VSTD_StrView){.ptr = view.ptr + index, .len = len};
+}
+
+VSTD_STATIC const char *vstd_strview_find(_VSTD_StrView view, const char *sub) {
+  return _vstd_mem_find(view.ptr, view.len, sub, strlen(sub));
+}
+
+VSTD_INLINE const char *vstd_strview_find_char(_VSTD_StrView view, char c) {
+  if (!view.len) {
+    return NULL;
+  }
+  return (const char *)memchr(view.ptr, c, view.len);
+}
+
+VSTD_STATIC bool vstd_strview_split_once(_VSTD_StrView view, const char *delim,
+                                         _VSTD_StrView *head,
+                                         _VSTD_StrView *tail) {
+  usize len = strlen(delim);
+  const char *ptr = _vstd_mem_find(view.ptr, view.len, delim, len);
+
+  if (!ptr) {
+    *head = view;
+    *tail = (_VSTD_StrView){.ptr = view.ptr + view.len, .len = 0};
+    return false;
+  }
+
+  usize index = (usize)(ptr - view.ptr);
+  *head = (_VSTD_StrView){.ptr = view.ptr, .len = index};
+  *tail = (_VSTD_StrView){.ptr = ptr + len, .len = view.len - index - len};
+
+  return true;
+}
+
+VSTD_INLINE _VSTD_StrSplit vstd_strview_split(_VSTD_StrView view,
+                                              const char *delim) {
+  return (_VSTD_StrSplit){
+      .rest = view,
+      .delim = delim,
+      .delim_len = strlen(delim),
+      .done = false,
+  };
+}
+
+VSTD_STATIC bool vstd_strview_split_next(_VSTD_StrSplit *split,
+                                         _VSTD_StrView *out) {
+  if (split->done) {
+    return false;
+  }
+
+  const char *ptr = _vstd_mem_find(split->rest.ptr, split->rest.len,
+                                   split->delim, split->delim_len);
+  if (!ptr) {
+    *out = split->rest;
+    split->done = true;
+    return true;
+  }
+
+  usize index = (usize)(ptr - split->rest.ptr);
+  *out = (_VSTD_StrView){.ptr = split->rest.ptr, .len = index};
+
+  split->rest.ptr = ptr + split->delim_len;
+  split->rest.len -= index + split->delim_len;
+
+  return true;
+}
+
+VSTD_INLINE _VSTD_StrView vstd_strview_trim(_VSTD_StrView view) {
+  return vstd_strview_trim_right(vstd_strview_trim_left(view));
+}
+
+VSTD_STATIC _VSTD_StrView vstd_strview_trim_left(_VSTD_StrView view) {
+  while (view.len && isspace((u8)view.ptr[0])) {
+    view.ptr++;
+    view.len--;
+  }
+  return view;
+}
+
+VSTD_STATIC _VSTD_StrView vstd_strview_trim_right(_VSTD_StrView view) {
+  while (view.len && isspace((u8)view.ptr[view.len - 1])) {
+    view.len--;
+  }
+  return view;
+}
+
+VSTD_INLINE bool vstd_strview_starts_with(_VSTD_StrView view,
+                                          const char *prefix) {
+  usize len = strlen(prefix);
+  return len <= view.len && memcmp(view.ptr, prefix, len) == 0;
+}
+
+VSTD_INLINE bool vstd_strview_ends_with(_VSTD_StrView view,
+                                        const char *suffix) {
+  usize len = strlen(suffix);
+  return len <= view.len &&
+         memcmp(view.ptr + view.len - len, suffix, len) == 0;
+}
+
+VSTD_STATIC isize vstd_strview_compare(_VSTD_StrView a, _VSTD_StrView b) {
+  usize len = a.len < b.len ? a.len : b.len;
+
+  i32 rc = len ? memcmp(a.ptr, b.ptr, len) : 0;
+  if (rc != 0) {
+    return rc;
+  }
+
+  return (a.len > b.len) - (a.len < b.len);
+}
+
+VSTD_INLINE bool vstd_strview_equal(_VSTD_StrView a, _VSTD_StrView b) {
+  return a.len == b.len && (!a.len || memcmp(a.ptr, b.ptr, a.len) == 0);
+}
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD HString
+ *
+ * @description
+ *   Strings carrying their precomputed hash, meant to be used as map keys.
+ *   The hash is computed once when the string is created, so comparisons can
+ *   reject on a hash or length mismatch without reading the characters. The
+ *   string must not be modified after it's created, or its hash goes stale.
+ *
+ * */
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_HString
+ *
+ * @description:
+ *   HString implementation, hash is the vstd_hash_bytes hash of the string's
+ *   characters, seeded with the seed of the predefined map hashes at the time
+ *   the string was created.
+ *
+ * */
+struct _VSTD_HString {
+  _VSTD_String string;
+  u64 hash;
+};
+
+#ifdef VSTD_HSTRING_STRIP_PREFIX
+typedef struct _VSTD_HString HString;
+#define _VSTD_HString HString
+#else
+typedef struct _VSTD_HString VSTD_HString;
+#define _VSTD_HString VSTD_HString
+#endif
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_hstring_from_string
+ *
+ * @description
+ *   Creates a new _VSTD_HString taking ownership of the given _VSTD_String.
+ *
+ * @param[in]
+ *   string : _VSTD_String to take.
+ *
+ * @return
+ *   New _VSTD_HString.
+ *
+ * */
+VSTD_INLINE _VSTD_HString vstd_hstring_from_string(_VSTD_String string) {
+  return (_VSTD_HString){
+      .string = string,
+      .hash = vstd_hash_bytes(vstd_string_ptr(&string),
+                              vstd_string_len(&string), _vstd_hash_seed),
+  };
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_hstring_from_view
+ *
+ * @description
+ *   Creates a new _VSTD_HString, copying the characters of the view.
+ *
+ * @param[in]
+ *   view : _VSTD_StrView to copy.
+ *
+ * @return
+ *   New _VSTD_HString.
+ *
+ * */
+VSTD_INLINE _VSTD_HString vstd_hstring_from_view(_VSTD_StrView view) {
+  return vstd_hstring_from_string(vstd_strview_to_string(view));
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_hstring_from
+ *
+ * @description
+ *   Creates a new _VSTD_HString, copying the null terminated string.
+ *
+ * @param[in]
+ *   str : String to copy.
+ *
+ * @return
+ *   New _VSTD_HString.
+ *
+ * */
+VSTD_INLINE _VSTD_HString vstd_hstring_from(const char *str) {
+  return vstd_hstring_from_string(vstd_string_from(str));
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_hstring_view
+ *
+ * @description
+ *   Returns a view of the characters of the _VSTD_HString.
+ *
+ * @param[in]
+ *   string : Pointer to _VSTD_HString to view.
+ *
+ * @return
+ *   _VSTD_StrView of the string.
+ *
+ * */
+VSTD_INLINE _VSTD_StrView vstd_hstring_view(const _VSTD_HString *string) {
+  return vstd_strview_from_string(&string->string);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_hstring_equal
+ *
+ * @description
+ *   Compares two _VSTD_HStrings, checking their hashes and lengths before
+ *   their characters.
+ *
+ * @param[in]
+ *   a : Pointer to the first _VSTD_HString.
+ * @param[in]
+ *   b : Pointer to the second _VSTD_HString.
+ *
+ * @return
+ *   true if the strings are equal, false otherwise.
+ *
+ * */
+VSTD_INLINE bool vstd_hstring_equal(const _VSTD_HString *a,
+                                    const _VSTD_HString *b) {
+  usize len = vstd_string_len(&a->string);
+  return a->hash == b->hash && len == vstd_string_len(&b->string) &&
+         memcmp(vstd_string_ptr(&a->string), vstd_string_ptr(&b->string),
+                len) == 0;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_hstring_free
+ *
+ * @description
+ *   Frees the underlying _VSTD_String of the given _VSTD_HString.
+ *
+ * @param[in]
+ *   string : Pointer to _VSTD_HString to free.
+ *
+ * */
+VSTD_INLINE void vstd_hstring_free(_VSTD_HString *string) {
+  vstd_string_free(&string->string);
+  string->hash = 0;
+}
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Vector
+ *
+ * */
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_Vector
+ *
+ * @description:
+ *   Vector implementation, this struct never allocates memory for itself, but
+ *   only for its underlying pointer. When passing an instance of this type its
+ *   safe to pass it as it is to a function, as long as that function doesn't
+ *   modify the vector's pointer or other properties. Otherwise you should pass
+ *   it as a reference, or you may lose the underlying pointer. If alloc is not
+ *   NULL, the underlying pointer is allocated from that _VSTD_Allocator.
+ *
+ * */
+struct _VSTD_Vector {
+  void *ptr;
+  usize len;
+  usize cap;
+  const _VSTD_Allocator *alloc;
+};
+
+#ifdef VSTD_VECTOR_STRIP_PREFIX
+#define Vector(type) struct _VSTD_Vector
+#else
+#define VSTD_Vector(type) struct _VSTD_Vector
+#endif
+
+#ifndef VSTD_VECTOR_INITIAL_CAP
+#define VSTD_VECTOR_INITIAL_CAP 1
+#endif
+
+#ifndef VSTD_VECTOR_GROWTH_FACTOR
+#define VSTD_VECTOR_GROWTH_FACTOR 2
+#endif
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_vector_grow_cap
+ *
+ * @description
+ *   Calculates the capacity a vector grows to, by multiplying its capacity
+ *   with VSTD_VECTOR_GROWTH_FACTOR until it can hold the needed items. This is
+ *   a helper function and it's only meant to be used the vstd library
+ *   functions.
+ *
+ * @param[in]
+ *   cap : Current capacity of the vector.
+ * @param[in]
+ *   needed : Number of items the vector has to hold.
+ *
+ * @return
+ *   New capacity of the vector.
+ *
+ * */
+VSTD_INLINE usize _vstd_vector_grow_cap(usize cap, usize needed) {
+  usize new_cap = cap ? cap : VSTD_VECTOR_INITIAL_CAP;
+  while (new_cap < needed) {
+    usize next = (usize)((f64)new_cap * VSTD_VECTOR_GROWTH_FACTOR);
+    new_cap = next > new_cap ? next : new_cap + 1;
+  }
+  return new_cap;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_vector_set_cap
+ *
+ * @description
+ *   Reallocates the underlying pointer of the vector to exactly the given
+ *   capacity, which can't be smaller than its length. This is a helper
+ *   function and it's only meant to be used the vstd library functions.
+ *
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ * @param[in]
+ *   size : Size of the vector's items.
+ * @param[in]
+ *   cap : New capacity of the vector.
+ *
+ * */
+VSTD_STATIC void _vstd_vector_set_cap(struct _VSTD_Vector *vec, usize size,
+                                      usize cap) {
+  if (!cap) {
+    vstd_free(vec->alloc, vec->ptr, size * vec->cap);
+    vec->ptr = NULL;
+  } else {
+    vec->ptr = vstd_realloc(vec->alloc, vec->ptr, size * vec->cap, size * cap);
+  }
+  vec->cap = cap;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_vector_grow
+ *
+ * @description
+ *   Grows the vector geometrically, until it can hold the needed items. This
+ *   is a helper function and it's only meant to be used the vstd library
+ *   functions.
+ *
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ * @param[in]
+ *   size : Size of the vector's items.
+ * @param[in]
+ *   needed : Number of items the vector has to hold.
+ *
+ * */
+VSTD_INLINE void _vstd_vector_grow(struct _VSTD_Vector *vec, usize size,
+                                   usize needed) {
+  if (needed > vec->cap) {
+    _vstd_vector_set_cap(vec, size, _vstd_vector_grow_cap(vec->cap, needed));
+  }
+}
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_new
+ *
+ * @description
+ *   Creates a new empty _VSTD_Vector object, this macro internally just calls
+ *   vstd_vector_with_capacity with VSTD_VECTOR_INITIAL_CAP as the argument.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ *
+ * @return
+ *   New empty _VSTD_Vector with capacity of VSTD_VECTOR_INITIAL_CAP.
+ *
+ * */
+#define vstd_vector_new(type)                                                  \
+  vstd_vector_with_capacity(type, VSTD_VECTOR_INITIAL_CAP)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_with_capacity
+ *
+ * @description
+ *   Creates a new empty _VSTD_Vector object with the given capacity.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   capacity : Capacity of the new _VSTD_Vector.
+ *
+ * @return
+ *   New empty _VSTD_Vector with given capacity.
+ *
+ * */
+#define vstd_vector_with_capacity(type, capacity)                              \
+  (struct _VSTD_Vector) {                                                      \
+    .ptr = VSTD_MALLOC(sizeof(type) * capacity), .cap = capacity, .len = 0,    \
+    .alloc = NULL                                                              \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_with_allocator
+ *
+ * @description
+ *   Creates a new empty _VSTD_Vector object with the given capacity, which is
+ *   bound to the allocator. Every reallocation of the vector, and of its clones
+ *   is made from the same allocator.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   capacity : Capacity of the new _VSTD_Vector.
+ * @param[in]
+ *   allocator : Pointer to the _VSTD_Allocator to bind the vector to.
+ *
+ * @return
+ *   New empty _VSTD_Vector with given capacity.
+ *
+ * */
+#define vstd_vector_with_allocator(type, capacity, allocator)                  \
+  (struct _VSTD_Vector) {                                                      \
+    .ptr = vstd_alloc(allocator, sizeof(type) * capacity), .cap = capacity,    \
+    .len = 0, .alloc = allocator                                               \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_from
+ *
+ * @description
+ *   Creates a new _VSTD_Vector containing the data in the initializer list.
+ *   Data is first assigned to a temporary variable then copied to the var.
+ *   Returns a non-allocated _VSTD_Vector to allow single line initializations.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[out]
+ *   var : Variable to assign the vector.
+ * @param[in]
+ *   ... : Initializer list
+ *
+ * @return
+ *   New non-allocated _VSTD_Vector.
+ *
+ * */
+#define vstd_vector_from(type, var, ...)                                       \
+  (struct _VSTD_Vector){};                                                     \
+  do {                                                                         \
+    type temp[] = __VA_ARGS__;                                                 \
+    var.ptr = VSTD_MALLOC(sizeof(temp));                                       \
+    memcpy(var.ptr, temp, sizeof(temp));                                       \
+    var.cap = sizeof(temp) / sizeof(type);                                     \
+    var.len = var.cap;                                                         \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_clone
+ *
+ * @description
+ *   Clones the given _VSTD_Vector and assigns the clone to var. Returns a
+ *   non-allocated _VSTD_Vector to allow single line initializations.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[out]
+ *   var : Variable to assign the clone.
+ * @param[in]
+ *   other : _VSTD_Vector to clone.
+ *
+ * @return
+ *   New non-allocated _VSTD_Vector.
+ *
+ * */
+#define vstd_vector_clone(type, var, other)                                    \
+  (struct _VSTD_Vector){};                                                     \
+  do {                                                                         \
+    var.ptr = vstd_alloc(other.alloc, sizeof(type) * other.cap);               \
+    memcpy(var.ptr, other.ptr, sizeof(type) * other.len);                      \
+    var.cap = other.cap;                                                       \
+    var.len = other.len;                                                       \
+    var.alloc = other.alloc;                                                   \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_get
+ *
+ * @description
+ *   Returns the item at the given index. This is the intended way to access an
+ *   element from _VSTD_Vector since _VSTD_Vector needs to be casted to desired
+ *   type first.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : _VSTD_Vector to retrieve the item from.
+ * @param[in]
+ *   index : Index of the item.
+ *
+ * @return
+ *   Item at given index.
+ *
+ * */
+#define vstd_vector_get(type, vec, index) ((type *)vec.ptr)[index]
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_set
+ *
+ * @description
+ *   Replaces the item at the given index with the item. This macro doesn't
+ *   modify the _VSTD_Vector but only the item at given index.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ * @param[in]
+ *   index : Target index to replace.
+ * @param[in]
+ *   item : Item to replace with.
+ *
+ * */
+#define vstd_vector_set(type, vec, index, item)                                \
+  do {                                                                         \
+    ((type *)vec->ptr)[index] = item;                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_push
+ *
+ * @description
+ *   Pushes a new item to the end of the given _VSTD_Vector. This macro may
+ *   resize the _VSTD_Vector.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ * @param[in]
+ *   item : Item to add.
+ *
+ * */
+#define vstd_vector_push(type, vec, item)                                      \
+  do {                                                                         \
+    if (vec->len >= vec->cap) {                                                \
+      _vstd_vector_grow(vec, sizeof(type), vec->len + 1);                      \
+    }                                                                          \
+    vstd_vector_set(type, vec, vec->len, item);                                \
+    vec->len++;                                                                \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_reserve
+ *
+ * @description
+ *   Makes sure the given _VSTD_Vector can hold at least capacity items without
+ *   reallocating. The capacity is reserved exactly, without applying
+ *   VSTD_VECTOR_GROWTH_FACTOR.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ * @param[in]
+ *   capacity : Minimum capacity of the _VSTD_Vector.
+ *
+ * */
+#define vstd_vector_reserve(type, vec, capacity)                               \
+  do {                                                                         \
+    if ((usize)(capacity) > vec->cap) {                                        \
+      _vstd_vector_set_cap(vec, sizeof(type), capacity);                       \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_push_n
+ *
+ * @description
+ *   Pushes count items to the end of the given _VSTD_Vector, with at most one
+ *   reallocation and a single copy. This macro may resize the _VSTD_Vector.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ * @param[in]
+ *   items : Pointer to the items to add.
+ * @param[in]
+ *   count : Number of items to add.
+ *
+ * */
+#define vstd_vector_push_n(type, vec, items, count)                            \
+  do {                                                                         \
+    usize _count = (count);                                                    \
+    _vstd_vector_grow(vec, sizeof(type), vec->len + _count);                   \
+    memcpy(((type *)vec->ptr) + vec->len, items, sizeof(type) * _count);       \
+    vec->len += _count;                                                        \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_extend
+ *
+ * @description
+ *   Pushes every item of the other _VSTD_Vector to the end of the given
+ *   _VSTD_Vector, see vstd_vector_push_n.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vectors' data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ * @param[in]
+ *   other : _VSTD_Vector to copy the items from.
+ *
+ * */
+#define vstd_vector_extend(type, vec, other)                                   \
+  vstd_vector_push_n(type, vec, other.ptr, other.len)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_resize
+ *
+ * @description
+ *   Changes the length of the given _VSTD_Vector. If the new length is longer,
+ *   the new items are set to item, otherwise the vector is truncated.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ * @param[in]
+ *   length : New length of the _VSTD_Vector.
+ * @param[in]
+ *   item : Item to fill the new slots with.
+ *
+ * */
+#define vstd_vector_resize(type, vec, length, item)                            \
+  do {                                                                         \
+    usize _length = (length);                                                  \
+    if (_length > vec->len) {                                                  \
+      _vstd_vector_grow(vec, sizeof(type), _length);                           \
+      type _item = (item);                                                     \
+      for (type *_ptr = ((type *)vec->ptr) + vec->len,                         \
+                *_end = ((type *)vec->ptr) + _length;                          \
+           _ptr < _end; ++_ptr) {                                              \
+        *_ptr = _item;                                                         \
+      }                                                                        \
+    }                                                                          \
+    vec->len = _length;                                                        \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_shrink_to_fit
+ *
+ * @description
+ *   Reallocates the underlying pointer of the given _VSTD_Vector, so its
+ *   capacity is the same as its length. An empty _VSTD_Vector is freed.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ *
+ * */
+#define vstd_vector_shrink_to_fit(type, vec)                                   \
+  do {                                                                         \
+    if (vec->cap > vec->len) {                                                 \
+      _vstd_vector_set_cap(vec, sizeof(type), vec->len);                       \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_remove
+ *
+ * @description
+ *   Removes the item at the given index from _VSTD_Vector. If item is not at
+ *   the end of the _VSTD_Vector, remaining items are shifted to left.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ * @param[in]
+ *   index : Index to remove.
+ *
+ * */
+#define vstd_vector_remove(type, vec, index)                                   \
+  do {                                                                         \
+    if (index != ((isize)vec->len - 1)) {                                      \
+      type *ptr = ((type *)vec->ptr) + index;                                  \
+      memmove(ptr, ptr + 1, (vec->len - (index + 1)) * sizeof(type));          \
+    }                                                                          \
+    vec->len--;                                                                \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_swap_remove
+ *
+ * @description
+ *   Removes the item at the given index from _VSTD_Vector in O(1), by moving
+ *   the last item into its place. The order of the items is not preserved.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ * @param[in]
+ *   index : Index to remove.
+ *
+ * */
+#define vstd_vector_swap_remove(type, vec, index)                              \
+  do {                                                                         \
+    usize _index = (index);                                                    \
+    vec->len--;                                                                \
+    ((type *)vec->ptr)[_index] = ((type *)vec->ptr)[vec->len];                 \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_retain
+ *
+ * @description
+ *   Keeps only the items of the _VSTD_Vector for which the condition is true,
+ *   compacting the remaining items in a single pass while keeping their order.
+ *   The condition can access the current item from _$iter and its original
+ *   index from _$i.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ * @param[in]
+ *   ... : Condition to evaluate for every item.
+ *
+ * */
+#define vstd_vector_retain(type, vec, ...)                                     \
+  do {                                                                         \
+    type *_$ptr = (type *)vec->ptr;                                            \
+    usize _$len = 0;                                                           \
+    for (usize _$i = 0; _$i < vec->len; ++_$i) {                               \
+      type *_$iter = _$ptr + _$i;                                              \
+      if (__VA_ARGS__) {                                                       \
+        if (_$len != _$i) {                                                    \
+          _$ptr[_$len] = *_$iter;                                              \
+        }                                                                      \
+        _$len++;                                                               \
+      }                                                                        \
+      (void)(_$iter);                                                          \
+    }                                                                          \
+    vec->len = _$len;                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_remove_if
+ *
+ * @description
+ *   Removes every item of the _VSTD_Vector for which the condition is true,
+ *   see vstd_vector_retain.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to modify.
+ * @param[in]
+ *   ... : Condition to evaluate for every item.
+ *
+ * */
+#define vstd_vector_remove_if(type, vec, ...)                                  \
+  vstd_vector_retain(type, vec, !(__VA_ARGS__))
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_iter
+ *
+ * @description
+ *   Helper function to easily iterate trough the length of the _VSTD_Vector.
+ *   In every iteration it is possible to access the current item from _$iter
+ *   and current index from _$i.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : _VSTD_Vector to iterate.
+ * @param[in]
+ *   ... : A single function or a block of code to execute every iteration.
+ *
+ * */
+#define vstd_vector_iter(type, vec, ...)                                       \
+  do {                                                                         \
+    for (usize _$i = 0; _$i < vec.len; ++_$i) {                                \
+      type *_$iter = ((type *)vec.ptr) + _$i;                                  \
+      __VA_ARGS__;                                                             \
+      (void)(_$i);                                                             \
+      (void)(_$iter);                                                          \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_clear
+ *
+ * @description
+ *   Set's given _VSTD_Vector's length to 0, basically soft resetting it. This
+ *   doesn't actually modify or free the underlying pointer.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to clear.
+ *
+ * */
+#define vstd_vector_clear(type, vec)                                           \
+  do {                                                                         \
+    vec->len = 0;                                                              \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_free
+ *
+ * @description
+ *   Frees the underlying pointer of the given _VSTD_Vector.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   vec : Pointer to _VSTD_Vector to free.
+ *
+ * */
+#define vstd_vector_free(type, vec)                                            \
+  do {                                                                         \
+    vstd_free(vec->alloc, vec->ptr, vec->cap * sizeof(type));                  \
+    vec->ptr = NULL;                                                           \
+    vec->cap = 0;                                                              \
+    vec->len = 0;                                                              \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   VSTD_VECTOR_DEFINE
+ *
+ * @description
+ *   Defines a typed vector struct with the given name, which has the same
+ *   layout as _VSTD_Vector but a T pointer, and the following typed functions
+ *   working on it:
+ *
+ *     name name_new(void);
+ *     name name_with_capacity(usize cap);
+ *     name name_with_allocator(usize cap, const _VSTD_Allocator *allocator);
+ *     void name_reserve(name *vec, usize cap);
+ *     void name_shrink_to_fit(name *vec);
+ *     void name_push(name *vec, T item);
+ *     void name_push_n(name *vec, const T *items, usize count);
+ *     T name_pop(name *vec);
+ *     T name_get(const name *vec, usize index);
+ *     T *name_at(const name *vec, usize index);
+ *     void name_set(name *vec, usize index, T item);
+ *     void name_remove(name *vec, usize index);
+ *     void name_swap_remove(name *vec, usize index);
+ *     void name_clear(name *vec);
+ *     void name_free(name *vec);
+ *
+ *   Typed vectors can be iterated with vstd_vector_typed_iter.
+ *
+ * @param[in]
+ *   name : Name of the struct, also used as the prefix of the functions.
+ * @param[in]
+ *   T : Type of the vector's data.
+ *
+ * */
+#define VSTD_VECTOR_DEFINE(name, T)                                            \
+  typedef struct name {                                                        \
+    T *ptr;                                                                    \
+    usize len;                                                                 \
+    usize cap;                                                                 \
+    const _VSTD_Allocator *alloc;                                              \
+  } name;                                                                      \
+                                                                               \
+  VSTD_INLINE name name##_with_allocator(usize cap,                            \
+                                         const _VSTD_Allocator *allocator) {   \
+    return (name){                                                             \
+        .ptr = (T *)vstd_alloc(allocator, sizeof(T) * cap),                    \
+        .len = 0,                                                              \
+        .cap = cap,                                                            \
+        .alloc = allocator,                                                    \
+    };                                                                         \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name name##_with_capacity(usize cap) {                           \
+    return name##_with_allocator(cap, NULL);                                   \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name name##_new(void) {                                          \
+    return name##_with_capacity(VSTD_VECTOR_INITIAL_CAP);                      \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_set_cap(name *vec, usize cap) {                      \
+    if (!cap) {                                                                \
+      vstd_free(vec->alloc, vec->ptr, sizeof(T) * vec->cap);                   \
+      vec->ptr = NULL;                                                         \
+    } else {                                                                   \
+      vec->ptr = (T *)vstd_realloc(vec->alloc, vec->ptr, sizeof(T) * vec->cap, \
+                                   sizeof(T) * cap);                           \
+    }                                                                          \
+    vec->cap = cap;                                                            \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_reserve(name *vec, usize cap) {                      \
+    if (cap > vec->cap) {                                                      \
+      name##_set_cap(vec, cap);                                                \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_shrink_to_fit(name *vec) {                           \
+    if (vec->cap > vec->len) {                                                 \
+      name##_set_cap(vec, vec->len);                                           \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_push(name *vec, T item) {                            \
+    if (vec->len >= vec->cap) {                                                \
+      name##_set_cap(vec, _vstd_vector_grow_cap(vec->cap, vec->len + 1));      \
+    }                                                                          \
+    vec->ptr[vec->len++] = item;                                               \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_push_n(name *vec, const T *items, usize count) {     \
+    if (vec->len + count > vec->cap) {                                         \
+      name##_set_cap(vec, _vstd_vector_grow_cap(vec->cap, vec->len + count));  \
+    }                                                                          \
+    memcpy(vec->ptr + vec->len, items, sizeof(T) * count);                     \
+    vec->len += count;                                                         \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE T name##_pop(name *vec) { return vec->ptr[--vec->len]; }         \
+                                                                               \
+  VSTD_INLINE T name##_get(const name *vec, usize index) {                     \
+    return vec->ptr[index];                                                    \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE T *name##_at(const name *vec, usize index) {                     \
+    return vec->ptr + index;                                                   \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_set(name *vec, usize index, T item) {                \
+    vec->ptr[index] = item;                                                    \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_remove(name *vec, usize index) {                     \
+    memmove(vec->ptr + index, vec->ptr + index + 1,                            \
+            sizeof(T) * (vec->len - index - 1));                               \
+    vec->len--;                                                                \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_swap_remove(name *vec, usize index) {                \
+    vec->ptr[index] = vec->ptr[--vec->len];                                    \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_clear(name *vec) { vec->len = 0; }                   \
+                                                                               \
+  VSTD_STATIC void name##_free(name *vec) {                                    \
+    vstd_free(vec->alloc, vec->ptr, sizeof(T) * vec->cap);                     \
+    vec->ptr = NULL;                                                           \
+    vec->len = 0;                                                              \
+    vec->cap = 0;                                                              \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_typed_iter
+ *
+ * @description
+ *   Same as vstd_vector_iter, but for vectors defined with VSTD_VECTOR_DEFINE,
+ *   whose type is known, so it doesn't have to be passed.
+ *
+ * @param[in]
+ *   vec : Typed vector to iterate.
+ * @param[in]
+ *   ... : A single function or a block of code to execute every iteration.
+ *
+ * */
+#define vstd_vector_typed_iter(vec, ...)                                       \
+  do {                                                                         \
+    for (usize _$i = 0; _$i < (vec).len; ++_$i) {                              \
+      __typeof__((vec).ptr) _$iter = (vec).ptr + _$i;                          \
+      __VA_ARGS__;                                                             \
+      (void)(_$i);                                                             \
+      (void)(_$iter);                                                          \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Sort
+ *
+ * @description
+ *   Sorting and searching for arrays and _VSTD_Vectors. VSTD_SORT_DEFINE
+ *   generates an introsort specialized for a type and a comparison, so the
+ *   comparison is inlined instead of being called through a pointer like with
+ *   qsort, together with a multi-threaded merge sort and binary searches.
+ *   Integer and float arrays can also be sorted with an LSD radix sort.
+ *
+ * */
+
+#ifndef VSTD_SORT_INSERTION_THRESHOLD
+#define VSTD_SORT_INSERTION_THRESHOLD 16
+#endif
+
+#ifndef VSTD_SORT_PARALLEL_THRESHOLD
+#define VSTD_SORT_PARALLEL_THRESHOLD (64 * 1024)
+#endif
+
+/*****************************************************************************
+ *
+ * @macro
+ *   VSTD_SORT_LESS
+ *
+ * @description
+ *   Default comparison for VSTD_SORT_DEFINE, compares with the < operator.
+ *
+ * */
+#define VSTD_SORT_LESS(a, b) ((a) < (b))
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_sort_threads
+ *
+ * @description
+ *   Returns the number of threads to use when 0 is requested, which is the
+ *   number of online processors. This is a helper function and it's only
+ *   meant to be used the vstd library functions.
+ *
+ * @param[in]
+ *   threads : Requested number of threads.
+ *
+ * @return
+ *   Number of threads to use.
+ *
+ * */
+VSTD_STATIC usize _vstd_sort_threads(usize threads) {
+  if (threads) {
+    return threads;
+  }
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? (usize)count : 1;
+}
+
+/*****************************************************************************
+ *
+ * @macro
+ *   VSTD_SORT_DEFINE
+ *
+ * @description
+ *   Defines sorting and searching functions for arrays of T, ordered by less,
+ *   which is called as less(a, b) with two values of T and must return true
+ *   if a goes before b. It can be a function or a function-like macro, such
+ *   as VSTD_SORT_LESS. The following functions are defined:
+ *
+ *     void name_sort(T *ptr, usize len);
+ *     void name_par_sort(T *ptr, usize len, usize threads);
+ *     usize name_lower_bound(const T *ptr, usize len, T key);
+ *     usize name_upper_bound(const T *ptr, usize len, T key);
+ *     bool name_binary_search(const T *ptr, usize len, T key, usize *index);
+ *
+ *   name_sort is an introsort, it's not stable. name_par_sort sorts equal
+ *   parts of the array on up to threads threads, or on every online processor
+ *   if threads is 0, and merges them in parallel. Arrays shorter than
+ *   VSTD_SORT_PARALLEL_THRESHOLD are sorted by name_sort.
+ *
+ * @param[in]
+ *   name : Prefix of the functions.
+ * @param[in]
+ *   T : Type of the items.
+ * @param[in]
+ *   less : Comparison of the items.
+ *
+ * */
+#define VSTD_SORT_DEFINE(name, T, less)                                        \
+  VSTD_INLINE void name##_insertion_sort(T *ptr, usize len) {                  \
+    for (usize i = 1; i < len; ++i) {                                          \
+      T item = ptr[i];                                                         \
+      usize j = i;                                                             \
+      for (; j > 0 && less(item, ptr[j - 1]); --j) {                           \
+        ptr[j] = ptr[j - 1];                                                   \
+      }                                                                        \
+      ptr[j] = item;                                                           \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_heap_sort(T *ptr, usize len) {                       \
+    for (usize start = len / 2, end = len; end > 1;) {                         \
+      if (start > 0) {                                                         \
+        --start;                                                               \
+      } else {                                                                 \
+        --end;                                                                 \
+        T tmp = ptr[0];                                                        \
+        ptr[0] = ptr[end];                                                     \
+        ptr[end] = tmp;                                                        \
+      }                                                                        \
+      usize root = start;                                                      \
+      for (usize child = root * 2 + 1; child < end; child = root * 2 + 1) {    \
+        if (child + 1 < end && less(ptr[child], ptr[child + 1])) {             \
+          child++;                                                             \
+        }                                                                      \
+        if (!less(ptr[root], ptr[child])) {                                    \
+          break;                                                               \
+        }                                                                      \
+        T tmp = ptr[root];                                                     \
+        ptr[root] = ptr[child];                                                \
+        ptr[child] = tmp;                                                      \
+        root = child;                                                          \
+      }                                                                        \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_intro_sort(T *ptr, usize len, usize depth) {         \
+    while (len > VSTD_SORT_INSERTION_THRESHOLD) {                              \
+      if (!depth--) {                                                          \
+        name##_heap_sort(ptr, len);                                            \
+        return;                                                                \
+      }                                                                        \
+                                                                               \
+      usize mid = len / 2;                                                     \
+      T tmp;                                                                   \
+      if (less(ptr[mid], ptr[0])) {                                            \
+        tmp = ptr[0], ptr[0] = ptr[mid], ptr[mid] = tmp;                       \
+      }                                                                        \
+      if (less(ptr[len - 1], ptr[mid])) {                                      \
+        tmp = ptr[mid], ptr[mid] = ptr[len - 1], ptr[len - 1] = tmp;           \
+        if (less(ptr[mid], ptr[0])) {                                          \
+          tmp = ptr[0], ptr[0] = ptr[mid], ptr[mid] = tmp;                     \
+        }                                                                      \
+      }                                                                        \
+                                                                               \
+      T pivot = ptr[mid];                                                      \
+      usize i = 0, j = len - 1;                                                \
+      for (;;) {                                                               \
+        while (less(ptr[i], pivot)) {                                          \
+          ++i;                                                                 \
+        }                                                                      \
+        while (less(pivot, ptr[j])) {                                          \
+          --j;                                                                 \
+        }                                                                      \
+        if (i >= j) {                                                          \
+          break;                                                               \
+        }                                                                      \
+        tmp = ptr[i], ptr[i] = ptr[j], ptr[j] = tmp;                           \
+        ++i;                                                                   \
+        --j;                                                                   \
+      }                                                                        \
+                                                                               \
+      usize left = j + 1;                                                      \
+      if (left < len - left) {                                                 \
+        name##_intro_sort(ptr, left, depth);                                   \
+        ptr += left;                                                           \
+        len -= left;                                                           \
+      } else {                                                                 \
+        name##_intro_sort(ptr + left, len - left, depth);                      \
+        len = left;                                                            \
+      }                                                                        \
+    }                                                                          \
+    name##_insertion_sort(ptr, len);                                           \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_sort(T *ptr, usize len) {                            \
+    usize depth = 0;                                                           \
+    for (usize n = len; n > 1; n >>= 1) {                                      \
+      depth += 2;                                                              \
+    }                                                                          \
+    name##_intro_sort(ptr, len, depth);                                        \
+  }                                                                            \
+                                                                               \
+  struct name##_sort_task {                                                    \
+    T *src;                                                                    \
+    T *dst;                                                                    \
+    usize lo;                                                                  \
+    usize mid;                                                                 \
+    usize hi;                                                                  \
+  };                                                                           \
+                                                                               \
+  VSTD_STATIC void *name##_sort_task_run(void *arg) {                          \
+    struct name##_sort_task *task = (struct name##_sort_task *)arg;            \
+    if (!task->dst) {                                                          \
+      name##_sort(task->src + task->lo, task->hi - task->lo);                  \
+      return NULL;                                                             \
+    }                                                                          \
+                                                                               \
+    const T *a = task->src + task->lo, *a_end = task->src + task->mid;         \
+    const T *b = a_end, *b_end = task->src + task->hi;                         \
+    T *out = task->dst + task->lo;                                             \
+    while (a < a_end && b < b_end) {                                           \
+      *out++ = less(*b, *a) ? *b++ : *a++;                                     \
+    }                                                                          \
+    memcpy(out, a, sizeof(T) * (a_end - a));                                   \
+    out += a_end - a;                                                          \
+    memcpy(out, b, sizeof(T) * (b_end - b));                                   \
+    return NULL;                                                               \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_sort_tasks_run(struct name##_sort_task *tasks,       \
+                                         usize count) {                        \
+    pthread_t *threads = (pthread_t *)VSTD_MALLOC(sizeof(pthread_t) * count);  \
+    bool *started = (bool *)VSTD_CALLOC(count, sizeof(bool));                  \
+    for (usize i = 1; i < count; ++i) {                                        \
+      started[i] = pthread_create(&threads[i], NULL, name##_sort_task_run,     \
+                                  &tasks[i]) == 0;                             \
+      if (!started[i]) {                                                       \
+        name##_sort_task_run(&tasks[i]);                                       \
+      }                                                                        \
+    }                                                                          \
+    name##_sort_task_run(&tasks[0]);                                           \
+    for (usize i = 1; i < count; ++i) {                                        \
+      if (started[i]) {                                                        \
+        pthread_join(threads[i], NULL);                                        \
+      }                                                                        \
+    }                                                                          \
+    VSTD_FREE(started);                                                        \
+    VSTD_FREE(threads);                                                        \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_par_sort(T *ptr, usize len, usize threads) {         \
+    usize runs = _vstd_sort_threads(threads);                                  \
+    if (runs > len / VSTD_SORT_PARALLEL_THRESHOLD) {                           \
+      runs = len / VSTD_SORT_PARALLEL_THRESHOLD;                               \
+    }                                                                          \
+    if (runs < 2) {                                                            \
+      name##_sort(ptr, len);                                                   \
+      return;                                                                  \
+    }                                                                          \
+                                                                               \
+    usize *bounds = (usize *)VSTD_MALLOC(sizeof(usize) * (runs + 1));          \
+    struct name##_sort_task *tasks = (struct name##_sort_task *)VSTD_MALLOC(   \
+        sizeof(struct name##_sort_task) * runs);                               \
+    for (usize i = 0; i <= runs; ++i) {                                        \
+      bounds[i] = len / runs * i + (i < len % runs ? i : len % runs);          \
+    }                                                                          \
+    for (usize i = 0; i < runs; ++i) {                                         \
+      tasks[i] = (struct name##_sort_task){                                    \
+          .src = ptr, .dst = NULL, .lo = bounds[i], .hi = bounds[i + 1]};      \
+    }                                                                          \
+    name##_sort_tasks_run(tasks, runs);                                        \
+                                                                               \
+    T *src = ptr;                                                              \
+    T *dst = (T *)VSTD_MALLOC(sizeof(T) * len);                                \
+    while (runs > 1) {                                                         \
+      usize count = 0;                                                         \
+      for (usize i = 0; i < runs; i += 2) {                                    \
+        usize hi = bounds[i + 2 <= runs ? i + 2 : runs];                       \
+        usize mid = i + 1 <= runs ? bounds[i + 1] : hi;                        \
+        tasks[count++] = (struct name##_sort_task){                            \
+            .src = src, .dst = dst, .lo = bounds[i], .mid = mid, .hi = hi};    \
+      }                                                                        \
+      name##_sort_tasks_run(tasks, count);                                     \
+                                                                               \
+      for (usize i = 0; i < count; ++i) {                                      \
+        bounds[i] = tasks[i].lo;                                               \
+      }                                                                        \
+      bounds[count] = len;                                                     \
+      runs = count;                                                            \
+      T *tmp = src;                                                            \
+      src = dst;                                                               \
+      dst = tmp;                                                               \
+    }                                                                          \
+                                                                               \
+    if (src != ptr) {                                                          \
+      memcpy(ptr, src, sizeof(T) * len);                                       \
+      dst = src;                                                               \
+    }                                                                          \
+    VSTD_FREE(dst);                                                            \
+    VSTD_FREE(tasks);                                                          \
+    VSTD_FREE(bounds);                                                         \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE usize name##_lower_bound(const T *ptr, usize len, T key) {       \
+    usize lo = 0;                                                              \
+    while (len) {                                                              \
+      usize half = len / 2;                                                    \
+      if (less(ptr[lo + half], key)) {                                         \
+        lo += half + 1;                                                        \
+        len -= half + 1;                                                       \
+      } else {                                                                 \
+        len = half;                                                            \
+      }                                                                        \
+    }                                                                          \
+    return lo;                                                                 \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE usize name##_upper_bound(const T *ptr, usize len, T key) {       \
+    usize lo = 0;                                                              \
+    while (len) {                                                              \
+      usize half = len / 2;                                                    \
+      if (!less(key, ptr[lo + half])) {                                        \
+        lo += half + 1;                                                        \
+        len -= half + 1;                                                       \
+      } else {                                                                 \
+        len = half;                                                            \
+      }                                                                        \
+    }                                                                          \
+    return lo;                                                                 \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE bool name##_binary_search(const T *ptr, usize len, T key,        \
+                                        usize *index) {                        \
+    usize i = name##_lower_bound(ptr, len, key);                               \
+    if (index) {                                                               \
+      *index = i;                                                              \
+    }                                                                          \
+    return i < len && !less(key, ptr[i]);                                      \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_sort
+ *
+ * @description
+ *   Sorts the _VSTD_Vector with the name_sort function defined by
+ *   VSTD_SORT_DEFINE.
+ *
+ * @param[in]
+ *   name : Name passed to VSTD_SORT_DEFINE.
+ * @param[in]
+ *   vec : _VSTD_Vector to sort.
+ *
+ * */
+#define vstd_vector_sort(name, vec) name##_sort((void *)vec.ptr, vec.len)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_par_sort
+ *
+ * @description
+ *   Sorts the _VSTD_Vector on multiple threads with the name_par_sort
+ *   function defined by VSTD_SORT_DEFINE.
+ *
+ * @param[in]
+ *   name : Name passed to VSTD_SORT_DEFINE.
+ * @param[in]
+ *   vec : _VSTD_Vector to sort.
+ * @param[in]
+ *   threads : Maximum number of threads, or 0 for every online processor.
+ *
+ * */
+#define vstd_vector_par_sort(name, vec, threads)                               \
+  name##_par_sort((void *)vec.ptr, vec.len, threads)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_lower_bound
+ *
+ * @description
+ *   Finds the index of the first item of the sorted _VSTD_Vector that doesn't
+ *   go before the key.
+ *
+ * @param[in]
+ *   name : Name passed to VSTD_SORT_DEFINE.
+ * @param[in]
+ *   vec : Sorted _VSTD_Vector to search.
+ * @param[in]
+ *   key : Key to search for.
+ *
+ * @return
+ *   Index of the item, or the length of the _VSTD_Vector.
+ *
+ * */
+#define vstd_vector_lower_bound(name, vec, key)                                \
+  name##_lower_bound((const void *)vec.ptr, vec.len, key)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_binary_search
+ *
+ * @description
+ *   Searches for the key in the sorted _VSTD_Vector.
+ *
+ * @param[in]
+ *   name : Name passed to VSTD_SORT_DEFINE.
+ * @param[in]
+ *   vec : Sorted _VSTD_Vector to search.
+ * @param[in]
+ *   key : Key to search for.
+ * @param[out]
+ *   index : Pointer to store the index of the key or where it would be
+ *           inserted, can be NULL.
+ *
+ * @return
+ *   True if the key is found, false otherwise.
+ *
+ * */
+#define vstd_vector_binary_search(name, vec, key, index)                       \
+  name##_binary_search((const void *)vec.ptr, vec.len, key, index)
+
+typedef u32 __attribute__((may_alias)) _VSTD_AliasU32;
+typedef u64 __attribute__((may_alias)) _VSTD_AliasU64;
+
+/*****************************************************************************
+ *
+ * @macro
+ *   _VSTD_RADIX_SORT
+ *
+ * @description
+ *   Body of the LSD radix sorts, sorts len unsigned keys of the given type a
+ *   byte at a time. Histograms of every byte are built in a single pass, and
+ *   passes where every key has the same byte are skipped. This is a helper
+ *   macro and it's only meant to be used the vstd library functions.
+ *
+ * */
+#define _VSTD_RADIX_SORT(type, ptr, len)                                       \
+  do {                                                                         \
+    if (len < 2) {                                                             \
+      return;                                                                  \
+    }                                                                          \
+                                                                               \
+    usize counts[sizeof(type)][256];                                           \
+    memset(counts, 0, sizeof(counts));                                         \
+    for (usize i = 0; i < len; ++i) {                                          \
+      for (usize d = 0; d < sizeof(type); ++d) {                               \
+        counts[d][(ptr[i] >> (d * 8)) & 0xFF]++;                               \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    type *tmp = (type *)VSTD_MALLOC(sizeof(type) * len);                       \
+    type *src = ptr, *dst = tmp;                                               \
+    for (usize d = 0; d < sizeof(type); ++d) {                                 \
+      usize shift = d * 8;                                                     \
+      if (counts[d][(src[0] >> shift) & 0xFF] == len) {                        \
+        continue;                                                              \
+      }                                                                        \
+                                                                               \
+      usize offset = 0;                                                        \
+      for (usize b = 0; b < 256; ++b) {                                        \
+        usize count = counts[d][b];                                            \
+        counts[d][b] = offset;                                                 \
+        offset += count;                                                       \
+      }                                                                        \
+      for (usize i = 0; i < len; ++i) {                                        \
+        dst[counts[d][(src[i] >> shift) & 0xFF]++] = src[i];                   \
+      }                                                                        \
+                                                                               \
+      type *swap = src;                                                        \
+      src = dst;                                                               \
+      dst = swap;                                                              \
+    }                                                                          \
+                                                                               \
+    if (src != ptr) {                                                          \
+      memcpy(ptr, src, sizeof(type) * len);                                    \
+    }                                                                          \
+    VSTD_FREE(tmp);                                                            \
+  } while (0)
+
+VSTD_STATIC void _vstd_radix_sort_32(_VSTD_AliasU32 *ptr, usize len) {
+  _VSTD_RADIX_SORT(_VSTD_AliasU32, ptr, len);
+}
+
+VSTD_STATIC void _vstd_radix_sort_64(_VSTD_AliasU64 *ptr, usize len) {
+  _VSTD_RADIX_SORT(_VSTD_AliasU64, ptr, len);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_radix_sort_u32
+ *
+ * @description
+ *   Sorts the array of u32 in ascending order with an LSD radix sort. The
+ *   vstd_radix_sort_u64, vstd_radix_sort_i32, vstd_radix_sort_i64,
+ *   vstd_radix_sort_f32 and vstd_radix_sort_f64 functions work the same way,
+ *   signed integers and floats are mapped to unsigned keys with the same order
+ *   before sorting and mapped back after. Negative zero goes before zero, and
+ *   NaNs go to the ends of the array, depending on their sign.
+ *
+ * @param[in]
+ *   ptr : Array to sort.
+ * @param[in]
+ *   len : Length of the array.
+ *
+ * */
+VSTD_STATIC void vstd_radix_sort_u32(u32 *ptr, usize len) {
+  _vstd_radix_sort_32(ptr, len);
+}
+
+VSTD_STATIC void vstd_radix_sort_u64(u64 *ptr, usize len) {
+  _vstd_radix_sort_64(ptr, len);
+}
+
+VSTD_STATIC void vstd_radix_sort_i32(i32 *ptr, usize len) {
+  _VSTD_AliasU32 *keys = (_VSTD_AliasU32 *)ptr;
+  for (usize i = 0; i < len; ++i) {
+    keys[i] ^= (u32)1 << 31;
+  }
+  _vstd_radix_sort_32(keys, len);
+  for (usize i = 0; i < len; ++i) {
+    keys[i] ^= (u32)1 << 31;
+  }
+}
+
+VSTD_STATIC void vstd_radix_sort_i64(i64 *ptr, usize len) {
+  _VSTD_AliasU64 *keys = (_VSTD_AliasU64 *)ptr;
+  for (usize i = 0; i < len; ++i) {
+    keys[i] ^= (u64)1 << 63;
+  }
+  _vstd_radix_sort_64(keys, len);
+  for (usize i = 0; i < len; ++i) {
+    keys[i] ^= (u64)1 << 63;
+  }
+}
+
+VSTD_STATIC void vstd_radix_sort_f32(f32 *ptr, usize len) {
+  _VSTD_AliasU32 *keys = (_VSTD_AliasU32 *)ptr;
+  for (usize i = 0; i < len; ++i) {
+    keys[i] ^= (u32)(-(i32)(keys[i] >> 31)) | ((u32)1 << 31);
+  }
+  _vstd_radix_sort_32(keys, len);
+  for (usize i = 0; i < len; ++i) {
+    keys[i] ^= (keys[i] >> 31) ? (u32)1 << 31 : ~(u32)0;
+  }
+}
+
+VSTD_STATIC void vstd_radix_sort_f64(f64 *ptr, usize len) {
+  _VSTD_AliasU64 *keys = (_VSTD_AliasU64 *)ptr;
+  for (usize i = 0; i < len; ++i) {
+    keys[i] ^= (u64)(-(i64)(keys[i] >> 63)) | ((u64)1 << 63);
+  }
+  _vstd_radix_sort_64(keys, len);
+  for (usize i = 0; i < len; ++i) {
+    keys[i] ^= (keys[i] >> 63) ? (u64)1 << 63 : ~(u64)0;
+  }
+}
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_radix_sort
+ *
+ * @description
+ *   Sorts the _VSTD_Vector with the matching vstd_radix_sort function.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data, one of u32, u64, i32, i64, f32
+ *          and f64.
+ * @param[in]
+ *   vec : _VSTD_Vector to sort.
+ *
+ * */
+#define vstd_vector_radix_sort(type, vec)                                      \
+  vstd_radix_sort_##type((type *)vec.ptr, vec.len)
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD SoA
+ *
+ * @description
+ *   Structure of arrays container. Every field of the records is stored in its
+ *   own contiguous column, so loops touching only a few fields read only their
+ *   columns, and per-field loops can be vectorized. Fields are listed with an
+ *   X-macro, which is called with the X macro for every field as X(type, name):
+ *
+ *     #define PARTICLE_FIELDS(X) X(f32, x) X(f32, y) X(u32, id)
+ *     VSTD_SOA_DEFINE(Particles, PARTICLE_FIELDS)
+ *
+ * */
+
+#ifndef VSTD_SOA_ALIGNMENT
+#define VSTD_SOA_ALIGNMENT 64
+#endif
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_soa_column_size
+ *
+ * @description
+ *   Returns the size of a column, rounded up to VSTD_SOA_ALIGNMENT so the next
+ *   column starts aligned. This is a helper function and it's only meant to be
+ *   used the vstd library functions.
+ *
+ * @param[in]
+ *   size : Size of the column's type.
+ * @param[in]
+ *   cap : Capacity of the column.
+ *
+ * @return
+ *   Size of the column in bytes.
+ *
+ * */
+VSTD_INLINE usize _vstd_soa_column_size(usize size, usize cap) {
+  return (size * cap + VSTD_SOA_ALIGNMENT - 1) &
+         ~(usize)(VSTD_SOA_ALIGNMENT - 1);
+}
+
+/*****************************************************************************
+ *
+ * @macro
+ *   _VSTD_SOA_ROW
+ *
+ * @description
+ *   _VSTD_SOA_ROW and the following macros are passed to the fields X-macro
+ *   by VSTD_SOA_DEFINE, to generate a declaration or a statement for every
+ *   field. They're helper macros and they're only meant to be used the vstd
+ *   library functions.
+ *
+ * */
+#define _VSTD_SOA_ROW(T, field) T field;
+#define _VSTD_SOA_COLUMN(T, field) T *field;
+#define _VSTD_SOA_SIZE(T, field) +_vstd_soa_column_size(sizeof(T), cap)
+#define _VSTD_SOA_MOVE(T, field)                                               \
+  if (soa->len) {                                                              \
+    memcpy(ptr, soa->field, sizeof(T) * soa->len);                             \
+  }                                                                            \
+  soa->field = (T *)ptr;                                                       \
+  ptr += _vstd_soa_column_size(sizeof(T), cap);
+#define _VSTD_SOA_PUSH(T, field) soa->field[soa->len] = row.field;
+#define _VSTD_SOA_GET(T, field) row.field = soa->field[index];
+#define _VSTD_SOA_SET(T, field) soa->field[index] = row.field;
+#define _VSTD_SOA_REMOVE(T, field)                                             \
+  memmove(soa->field + index, soa->field + index + 1,                          \
+          sizeof(T) * (soa->len - index - 1));
+#define _VSTD_SOA_SWAP_REMOVE(T, field)                                        \
+  soa->field[index] = soa->field[soa->len];
+
+/*****************************************************************************
+ *
+ * @macro
+ *   VSTD_SOA_DEFINE
+ *
+ * @description
+ *   Defines a structure of arrays with the given name, which has a column
+ *   pointer for every field, and a name_row struct holding a single record.
+ *   Every column is aligned to VSTD_SOA_ALIGNMENT, and all of them are stored
+ *   in a single allocation. The following functions are defined:
+ *
+ *     name name_new(void);
+ *     name name_with_capacity(usize cap);
+ *     name name_with_allocator(usize cap, const _VSTD_Allocator *allocator);
+ *     void name_reserve(name *soa, usize cap);
+ *     void name_push(name *soa, name_row row);
+ *     name_row name_get(const name *soa, usize index);
+ *     void name_set(name *soa, usize index, name_row row);
+ *     void name_remove(name *soa, usize index);
+ *     void name_swap_remove(name *soa, usize index);
+ *     void name_clear(name *soa);
+ *     void name_free(name *soa);
+ *
+ *   Fields can't be named len, cap, block, size or alloc.
+ *
+ * @param[in]
+ *   name : Name of the struct, also used as the prefix of the functions.
+ * @param[in]
+ *   FIELDS : X-macro listing the fields.
+ *
+ * */
+#define VSTD_SOA_DEFINE(name, FIELDS)                                          \
+  typedef struct name##_row {                                                  \
+    FIELDS(_VSTD_SOA_ROW)                                                      \
+  } name##_row;                                                                \
+                                                                               \
+  typedef struct name {                                                        \
+    FIELDS(_VSTD_SOA_COLUMN)                                                   \
+    usize len;                                                                 \
+    usize cap;                                                                 \
+    void *block;                                                               \
+    usize size;                                                                \
+    const _VSTD_Allocator *alloc;                                              \
+  } name;                                                                      \
+                                                                               \
+  VSTD_STATIC void name##_reserve(name *soa, usize cap) {                      \
+    if (cap <= soa->cap) {                                                     \
+      return;                                                                  \
+    }                                                                          \
+                                                                               \
+    usize size = VSTD_SOA_ALIGNMENT FIELDS(_VSTD_SOA_SIZE);                    \
+    u8 *block = (u8 *)vstd_alloc(soa->alloc, size);                            \
+    u8 *ptr = (u8 *)(((uptr)block + VSTD_SOA_ALIGNMENT - 1) &                  \
+                     ~(uptr)(VSTD_SOA_ALIGNMENT - 1));                         \
+    FIELDS(_VSTD_SOA_MOVE)                                                     \
+                                                                               \
+    if (soa->block) {                                                          \
+      vstd_free(soa->alloc, soa->block, soa->size);                            \
+    }                                                                          \
+    soa->block = block;                                                        \
+    soa->size = size;                                                          \
+    soa->cap = cap;                                                            \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name name##_with_allocator(usize cap,                            \
+                                         const _VSTD_Allocator *allocator) {   \
+    name soa;                                                                  \
+    memset(&soa, 0, sizeof(soa));                                              \
+    soa.alloc = allocator;                                                     \
+    name##_reserve(&soa, cap);                                                 \
+    return soa;                                                                \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name name##_with_capacity(usize cap) {                           \
+    return name##_with_allocator(cap, NULL);                                   \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name name##_new(void) {                                          \
+    return name##_with_capacity(VSTD_VECTOR_INITIAL_CAP);                      \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_push(name *soa, name##_row row) {                    \
+    if (soa->len >= soa->cap) {                                                \
+      name##_reserve(soa, _vstd_vector_grow_cap(soa->cap, soa->len + 1));      \
+    }                                                                          \
+    FIELDS(_VSTD_SOA_PUSH)                                                     \
+    soa->len++;                                                                \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name##_row name##_get(const name *soa, usize index) {            \
+    name##_row row;                                                            \
+    FIELDS(_VSTD_SOA_GET)                                                      \
+    return row;                                                                \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_set(name *soa, usize index, name##_row row) {        \
+    FIELDS(_VSTD_SOA_SET)                                                      \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_remove(name *soa, usize index) {                     \
+    FIELDS(_VSTD_SOA_REMOVE)                                                   \
+    soa->len--;                                                                \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_swap_remove(name *soa, usize index) {                \
+    soa->len--;                                                                \
+    FIELDS(_VSTD_SOA_SWAP_REMOVE)                                              \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_clear(name *soa) { soa->len = 0; }                   \
+                                                                               \
+  VSTD_STATIC void name##_free(name *soa) {                                    \
+    if (soa->block) {                                                          \
+      vstd_free(soa->alloc, soa->block, soa->size);                            \
+    }                                                                          \
+    const _VSTD_Allocator *allocator = soa->alloc;                             \
+    memset(soa, 0, sizeof(*soa));                                              \
+    soa->alloc = allocator;                                                    \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_soa_iter
+ *
+ * @description
+ *   Helper function to easily iterate trough the length of a structure of
+ *   arrays. In every iteration it is possible to access the current index from
+ *   _$i, and the fields through the columns, like soa.field[_$i].
+ *
+ * @param[in]
+ *   soa : Structure of arrays to iterate.
+ * @param[in]
+ *   ... : A single function or a block of code to execute every iteration.
+ *
+ * */
+#define vstd_soa_iter(soa, ...)                                                \
+  do {                                                                         \
+    for (usize _$i = 0, _$len = (soa).len; _$i < _$len; ++_$i) {               \
+      __VA_ARGS__;                                                             \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD SmallVector
+ *
+ * @description
+ *   Vectors with inline storage for a fixed number of items, which only spill
+ *   to the heap when they outgrow it. Small vectors don't allocate at all as
+ *   long as they stay small.
+ *
+ * */
+
+/*****************************************************************************
+ *
+ * @macro
+ *   VSTD_SMALL_VECTOR_DEFINE
+ *
+ * @description
+ *   Defines a small vector struct with the given name, which stores up to N
+ *   items inline. When it grows past N items they are moved to a heap block
+ *   allocated from alloc, pointed to by heap, which is NULL while the items
+ *   are inline. Because the inline items are a part of the struct, it can be
+ *   copied and returned by value freely while it's inline. The following
+ *   functions are defined:
+ *
+ *     name name_new(void);
+ *     name name_with_allocator(const _VSTD_Allocator *allocator);
+ *     T *name_data(name *vec);
+ *     bool name_is_inline(const name *vec);
+ *     void name_reserve(name *vec, usize cap);
+ *     void name_push(name *vec, T item);
+ *     void name_push_n(name *vec, const T *items, usize count);
+ *     T name_pop(name *vec);
+ *     T name_get(name *vec, usize index);
+ *     T *name_at(name *vec, usize index);
+ *     void name_set(name *vec, usize index, T item);
+ *     void name_remove(name *vec, usize index);
+ *     void name_swap_remove(name *vec, usize index);
+ *     void name_clear(name *vec);
+ *     void name_free(name *vec);
+ *
+ *   Small vectors can be iterated with vstd_small_vector_iter.
+ *
+ * @param[in]
+ *   name : Name of the struct, also used as the prefix of the functions.
+ * @param[in]
+ *   T : Type of the vector's data.
+ * @param[in]
+ *   N : Number of items stored inline.
+ *
+ * */
+#define VSTD_SMALL_VECTOR_DEFINE(name, T, N)                                   \
+  typedef struct name {                                                        \
+    T *heap;                                                                   \
+    usize len;                                                                 \
+    usize cap;                                                                 \
+    const _VSTD_Allocator *alloc;                                              \
+    T buf[N];                                                                  \
+  } name;                                                                      \
+                                                                               \
+  VSTD_INLINE name name##_with_allocator(const _VSTD_Allocator *allocator) {   \
+    return (name){.heap = NULL, .len = 0, .cap = N, .alloc = allocator};       \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name name##_new(void) { return name##_with_allocator(NULL); }    \
+                                                                               \
+  VSTD_INLINE T *name##_data(name *vec) {                                      \
+    return vec->heap ? vec->heap : vec->buf;                                   \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE bool name##_is_inline(const name *vec) { return !vec->heap; }    \
+                                                                               \
+  VSTD_STATIC void name##_reserve(name *vec, usize cap) {                      \
+    if (cap <= vec->cap) {                                                     \
+      return;                                                                  \
+    }                                                                          \
+    if (vec->heap) {                                                           \
+      vec->heap = (T *)vstd_realloc(vec->alloc, vec->heap,                     \
+                                    sizeof(T) * vec->cap, sizeof(T) * cap);    \
+    } else {                                                                   \
+      vec->heap = (T *)vstd_alloc(vec->alloc, sizeof(T) * cap);                \
+      memcpy(vec->heap, vec->buf, sizeof(T) * vec->len);                       \
+    }                                                                          \
+    vec->cap = cap;                                                            \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_push(name *vec, T item) {                            \
+    if (vec->len >= vec->cap) {                                                \
+      name##_reserve(vec, _vstd_vector_grow_cap(vec->cap, vec->len + 1));      \
+    }                                                                          \
+    name##_data(vec)[vec->len++] = item;                                       \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_push_n(name *vec, const T *items, usize count) {     \
+    if (vec->len + count > vec->cap) {                                         \
+      name##_reserve(vec, _vstd_vector_grow_cap(vec->cap, vec->len + count));  \
+    }                                                                          \
+    memcpy(name##_data(vec) + vec->len, items, sizeof(T) * count);             \
+    vec->len += count;                                                         \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE T name##_pop(name *vec) { return name##_data(vec)[--vec->len]; } \
+                                                                               \
+  VSTD_INLINE T name##_get(name *vec, usize index) {                           \
+    return name##_data(vec)[index];                                            \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE T *name##_at(name *vec, usize index) {                           \
+    return name##_data(vec) + index;                                           \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_set(name *vec, usize index, T item) {                \
+    name##_data(vec)[index] = item;                                            \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_remove(name *vec, usize index) {                     \
+    T *ptr = name##_data(vec);                                                 \
+    memmove(ptr + index, ptr + index + 1, sizeof(T) * (vec->len - index - 1)); \
+    vec->len--;                                                                \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_swap_remove(name *vec, usize index) {                \
+    T *ptr = name##_data(vec);                                                 \
+    ptr[index] = ptr[--vec->len];                                              \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_clear(name *vec) { vec->len = 0; }                   \
+                                                                               \
+  VSTD_STATIC void name##_free(name *vec) {                                    \
+    if (vec->heap) {                                                           \
+      vstd_free(vec->alloc, vec->heap, sizeof(T) * vec->cap);                  \
+    }                                                                          \
+    vec->heap = NULL;                                                          \
+    vec->len = 0;                                                              \
+    vec->cap = N;                                                              \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_small_vector_iter
+ *
+ * @description
+ *   Same as vstd_vector_iter, but for vectors defined with
+ *   VSTD_SMALL_VECTOR_DEFINE, whose type is known, so it doesn't have to be
+ *   passed.
+ *
+ * @param[in]
+ *   vec : Small vector to iterate.
+ * @param[in]
+ *   ... : A single function or a block of code to execute every iteration.
+ *
+ * */
+#define vstd_small_vector_iter(vec, ...)                                       \
+  do {                                                                         \
+    __typeof__((vec).buf[0]) *_$ptr = (vec).heap ? (vec).heap : (vec).buf;     \
+    for (usize _$i = 0; _$i < (vec).len; ++_$i) {                              \
+      __typeof__(_$ptr) _$iter = _$ptr + _$i;                                  \
+      __VA_ARGS__;                                                             \
+      (void)(_$i);                                                             \
+      (void)(_$iter);                                                          \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Deque
+ *
+ * @description
+ *   Double ended queue, implemented as a ring buffer with a power of two
+ *   capacity, so items can be pushed and popped at both ends in O(1). When
+ *   the buffer is full its capacity is doubled.
+ *
+ * */
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_Deque
+ *
+ * @description:
+ *   Deque implementation, the items are stored in ptr starting from the head
+ *   index, and wrap around to the start of ptr when they reach cap. Like
+ *   _VSTD_Vector, the struct never allocates memory for itself, so it should
+ *   be passed as a reference to functions modifying it.
+ *
+ * */
+struct _VSTD_Deque {
+  void *ptr;
+  usize head;
+  usize len;
+  usize cap;
+  const _VSTD_Allocator *alloc;
+};
+
+#ifdef VSTD_DEQUE_STRIP_PREFIX
+#define Deque(type) struct _VSTD_Deque
+#else
+#define VSTD_Deque(type) struct _VSTD_Deque
+#endif
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_DequeSpan
+ *
+ * @description:
+ *   Contiguous part of a _VSTD_Deque, len is the number of items in it.
+ *
+ * */
+struct _VSTD_DequeSpan {
+  void *ptr;
+  usize len;
+};
+
+#ifdef VSTD_DEQUE_STRIP_PREFIX
+typedef struct _VSTD_DequeSpan DequeSpan;
+#define _VSTD_DequeSpan DequeSpan
+#else
+typedef struct _VSTD_DequeSpan VSTD_DequeSpan;
+#define _VSTD_DequeSpan VSTD_DequeSpan
+#endif
+
+#ifndef VSTD_DEQUE_INITIAL_CAP
+#define VSTD_DEQUE_INITIAL_CAP 8
+#endif
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_deque_cap
+ *
+ * @description
+ *   Rounds the capacity up to a power of two. This is a helper function and
+ *   it's only meant to be used the vstd library functions.
+ *
+ * @param[in]
+ *   cap : Requested capacity.
+ *
+ * @return
+ *   Power of two capacity.
+ *
+ * */
+VSTD_INLINE usize _vstd_deque_cap(usize cap) {
+  usize pow = 1;
+  while (pow < cap) {
+    pow <<= 1;
+  }
+  return pow;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_deque_set_cap
+ *
+ * @description
+ *   Reallocates the deque to a larger power of two capacity. Items wrapping
+ *   around the end of the old buffer are moved after it, so the items stay in
+ *   order. This is a helper function and it's only meant to be used the vstd
+ *   library functions.
+ *
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to modify.
+ * @param[in]
+ *   size : Size of the deque's items.
+ * @param[in]
+ *   cap : New capacity, has to be a power of two and larger than the old one.
+ *
+ * */
+VSTD_STATIC void _vstd_deque_set_cap(struct _VSTD_Deque *deque, usize size,
+                                     usize cap) {
+  usize old_cap = deque->cap;
+  deque->ptr =
+      vstd_realloc(deque->alloc, deque->ptr, size * old_cap, size * cap);
+  deque->cap = cap;
+
+  if (deque->head + deque->len > old_cap) {
+    usize wrapped = deque->head + deque->len - old_cap;
+    memcpy((u8 *)deque->ptr + size * old_cap, deque->ptr, size * wrapped);
+  }
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_deque_push_back_index
+ *
+ * @description
+ *   Grows the deque if it's full, and reserves a slot at its back. This is a
+ *   helper function and it's only meant to be used the vstd library
+ *   functions.
+ *
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to modify.
+ * @param[in]
+ *   size : Size of the deque's items.
+ *
+ * @return
+ *   Index of the reserved slot in ptr.
+ *
+ * */
+VSTD_INLINE usize _vstd_deque_push_back_index(struct _VSTD_Deque *deque,
+                                              usize size) {
+  if (deque->len == deque->cap) {
+    _vstd_deque_set_cap(deque, size,
+                        deque->cap ? deque->cap * 2 : VSTD_DEQUE_INITIAL_CAP);
+  }
+  return (deque->head + deque->len++) & (deque->cap - 1);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_deque_push_front_index
+ *
+ * @description
+ *   Grows the deque if it's full, and reserves a slot at its front. This is a
+ *   helper function and it's only meant to be used the vstd library
+ *   functions.
+ *
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to modify.
+ * @param[in]
+ *   size : Size of the deque's items.
+ *
+ * @return
+ *   Index of the reserved slot in ptr.
+ *
+ * */
+VSTD_INLINE usize _vstd_deque_push_front_index(struct _VSTD_Deque *deque,
+                                               usize size) {
+  if (deque->len == deque->cap) {
+    _vstd_deque_set_cap(deque, size,
+                        deque->cap ? deque->cap * 2 : VSTD_DEQUE_INITIAL_CAP);
+  }
+  deque->head = (deque->head - 1) & (deque->cap - 1);
+  deque->len++;
+  return deque->head;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_deque_take_front
+ *
+ * @description
+ *   Removes the front item of a non-empty deque. The item stays in ptr until
+ *   the next push. This is a helper function and it's only meant to be used
+ *   the vstd library functions.
+ *
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to modify.
+ *
+ * @return
+ *   Index of the removed item in ptr.
+ *
+ * */
+VSTD_INLINE usize _vstd_deque_take_front(struct _VSTD_Deque *deque) {
+  usize index = deque->head;
+  deque->head = (deque->head + 1) & (deque->cap - 1);
+  deque->len--;
+  return index;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_deque_take_back
+ *
+ * @description
+ *   Removes the back item of a non-empty deque. The item stays in ptr until
+ *   the next push. This is a helper function and it's only meant to be used
+ *   the vstd library functions.
+ *
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to modify.
+ *
+ * @return
+ *   Index of the removed item in ptr.
+ *
+ * */
+VSTD_INLINE usize _vstd_deque_take_back(struct _VSTD_Deque *deque) {
+  deque->len--;
+  return (deque->head + deque->len) & (deque->cap - 1);
+}
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_new
+ *
+ * @description
+ *   Creates a new empty _VSTD_Deque object, with VSTD_DEQUE_INITIAL_CAP as its
+ *   capacity.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ *
+ * @return
+ *   New empty _VSTD_Deque.
+ *
+ * */
+#define vstd_deque_new(type)                                                   \
+  vstd_deque_with_capacity(type, VSTD_DEQUE_INITIAL_CAP)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_with_capacity
+ *
+ * @description
+ *   Creates a new empty _VSTD_Deque object with the given capacity, rounded up
+ *   to a power of two.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   capacity : Capacity of the new _VSTD_Deque.
+ *
+ * @return
+ *   New empty _VSTD_Deque.
+ *
+ * */
+#define vstd_deque_with_capacity(type, capacity)                               \
+  vstd_deque_with_allocator(type, capacity, NULL)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_with_allocator
+ *
+ * @description
+ *   Creates a new empty _VSTD_Deque object with the given capacity, rounded up
+ *   to a power of two, which is bound to the allocator.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   capacity : Capacity of the new _VSTD_Deque.
+ * @param[in]
+ *   allocator : Pointer to the _VSTD_Allocator to bind the deque to.
+ *
+ * @return
+ *   New empty _VSTD_Deque.
+ *
+ * */
+#define vstd_deque_with_allocator(type, capacity, allocator)                   \
+  (struct _VSTD_Deque) {                                                       \
+    .ptr = vstd_alloc(allocator, sizeof(type) * _vstd_deque_cap(capacity)),    \
+    .head = 0, .len = 0, .cap = _vstd_deque_cap(capacity), .alloc = allocator  \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_push_back
+ *
+ * @description
+ *   Pushes a new item to the back of the given _VSTD_Deque. This macro may
+ *   resize the _VSTD_Deque.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to modify.
+ * @param[in]
+ *   item : Item to add.
+ *
+ * */
+#define vstd_deque_push_back(type, deque, item)                                \
+  do {                                                                         \
+    usize _index = _vstd_deque_push_back_index(deque, sizeof(type));           \
+    ((type *)(deque)->ptr)[_index] = item;                                     \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_push_front
+ *
+ * @description
+ *   Pushes a new item to the front of the given _VSTD_Deque. This macro may
+ *   resize the _VSTD_Deque.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to modify.
+ * @param[in]
+ *   item : Item to add.
+ *
+ * */
+#define vstd_deque_push_front(type, deque, item)                               \
+  do {                                                                         \
+    usize _index = _vstd_deque_push_front_index(deque, sizeof(type));          \
+    ((type *)(deque)->ptr)[_index] = item;                                     \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_pop_front
+ *
+ * @description
+ *   Removes the front item of the given non-empty _VSTD_Deque.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to modify.
+ *
+ * @return
+ *   The removed item.
+ *
+ * */
+#define vstd_deque_pop_front(type, deque)                                      \
+  (((type *)(deque)->ptr)[_vstd_deque_take_front(deque)])
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_pop_back
+ *
+ * @description
+ *   Removes the back item of the given non-empty _VSTD_Deque.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to modify.
+ *
+ * @return
+ *   The removed item.
+ *
+ * */
+#define vstd_deque_pop_back(type, deque)                                       \
+  (((type *)(deque)->ptr)[_vstd_deque_take_back(deque)])
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_get
+ *
+ * @description
+ *   Returns the item at the given position, counted from the front of the
+ *   _VSTD_Deque.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   deque : _VSTD_Deque to access.
+ * @param[in]
+ *   index : Position of the item.
+ *
+ * @return
+ *   The item, which can also be assigned to.
+ *
+ * */
+#define vstd_deque_get(type, deque, index)                                     \
+  ((type *)(deque).ptr)[((deque).head + (index)) & ((deque).cap - 1)]
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_front
+ *
+ * @description
+ *   Returns the front item of the given non-empty _VSTD_Deque.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   deque : _VSTD_Deque to access.
+ *
+ * */
+#define vstd_deque_front(type, deque) vstd_deque_get(type, deque, 0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_back
+ *
+ * @description
+ *   Returns the back item of the given non-empty _VSTD_Deque.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   deque : _VSTD_Deque to access.
+ *
+ * */
+#define vstd_deque_back(type, deque)                                           \
+  vstd_deque_get(type, deque, (deque).len - 1)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_iter
+ *
+ * @description
+ *   Helper function to easily iterate trough the _VSTD_Deque from its front to
+ *   its back. In every iteration it is possible to access the current item
+ *   from _$iter and its position from _$i.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   deque : _VSTD_Deque to iterate.
+ * @param[in]
+ *   ... : A single function or a block of code to execute every iteration.
+ *
+ * */
+#define vstd_deque_iter(type, deque, ...)                                      \
+  do {                                                                         \
+    usize _$mask = (deque).cap - 1;                                            \
+    for (usize _$i = 0; _$i < (deque).len; ++_$i) {                            \
+      type *_$iter = ((type *)(deque).ptr) + (((deque).head + _$i) & _$mask);  \
+      __VA_ARGS__;                                                             \
+      (void)(_$i);                                                             \
+      (void)(_$iter);                                                          \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_deque_spans
+ *
+ * @description
+ *   Splits the items of a deque into at most two contiguous spans. This is a
+ *   helper function and it's only meant to be used the vstd library
+ *   functions.
+ *
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to access.
+ * @param[in]
+ *   size : Size of the deque's items.
+ * @param[out]
+ *   spans : Array of two _VSTD_DequeSpans to fill.
+ *
+ * @return
+ *   Number of non-empty spans.
+ *
+ * */
+VSTD_STATIC usize _vstd_deque_spans(const struct _VSTD_Deque *deque,
+                                    usize size, _VSTD_DequeSpan *spans) {
+  usize first = deque->cap - deque->head;
+  if (first > deque->len) {
+    first = deque->len;
+  }
+
+  spans[0] = (_VSTD_DequeSpan){
+      .ptr = (u8 *)deque->ptr + size * deque->head,
+      .len = first,
+  };
+  spans[1] = (_VSTD_DequeSpan){
+      .ptr = deque->ptr,
+      .len = deque->len - first,
+  };
+
+  return (first > 0) + (spans[1].len > 0);
+}
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_spans
+ *
+ * @description
+ *   Splits the items of the _VSTD_Deque into at most two contiguous spans, the
+ *   first span starts at the front and the second one ends at the back. The
+ *   spans can be written directly, for example with fwrite or writev.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   deque : _VSTD_Deque to access.
+ * @param[out]
+ *   spans : Array of two _VSTD_DequeSpans to fill.
+ *
+ * @return
+ *   Number of non-empty spans.
+ *
+ * */
+#define vstd_deque_spans(type, deque, spans)                                   \
+  _vstd_deque_spans(&(deque), sizeof(type), spans)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_reserve
+ *
+ * @description
+ *   Makes sure the given _VSTD_Deque can hold at least capacity items without
+ *   reallocating, the capacity is rounded up to a power of two.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to modify.
+ * @param[in]
+ *   capacity : Minimum capacity of the _VSTD_Deque.
+ *
+ * */
+#define vstd_deque_reserve(type, deque, capacity)                              \
+  do {                                                                         \
+    usize _capacity = _vstd_deque_cap(capacity);                               \
+    if (_capacity > (deque)->cap) {                                            \
+      _vstd_deque_set_cap(deque, sizeof(type), _capacity);                     \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_clear
+ *
+ * @description
+ *   Removes every item of the given _VSTD_Deque.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to modify.
+ *
+ * */
+#define vstd_deque_clear(type, deque)                                          \
+  do {                                                                         \
+    (deque)->head = 0;                                                         \
+    (deque)->len = 0;                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_deque_free
+ *
+ * @description
+ *   Frees the underlying pointer of the given _VSTD_Deque.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Deque's data.
+ * @param[in]
+ *   deque : Pointer to _VSTD_Deque to free.
+ *
+ * */
+#define vstd_deque_free(type, deque)                                           \
+  do {                                                                         \
+    vstd_free((deque)->alloc, (deque)->ptr, (deque)->cap * sizeof(type));      \
+    (deque)->ptr = NULL;                                                       \
+    (deque)->head = 0;                                                         \
+    (deque)->len = 0;                                                          \
+    (deque)->cap = 0;                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Queue
+ *
+ * @description
+ *   Bounded lock-free queues for passing items between threads, built on C11
+ *   atomics. VSTD_SPSC_QUEUE_DEFINE defines a single producer single consumer
+ *   ring, and VSTD_MPMC_QUEUE_DEFINE a multi producer multi consumer queue
+ *   with a sequence number per cell. The indices written by the producers and
+ *   the consumers are kept on separate cache lines, to avoid false sharing.
+ *
+ * */
+
+#ifndef VSTD_QUEUE_CACHE_LINE
+#define VSTD_QUEUE_CACHE_LINE 64
+#endif
+
+/*****************************************************************************
+ *
+ * @macro
+ *   VSTD_SPSC_QUEUE_DEFINE
+ *
+ * @description
+ *   Defines a bounded single producer single consumer queue struct with the
+ *   given name. Only one thread may push and only one thread may pop at the
+ *   same time. Each side caches the other side's index, so it only reads the
+ *   other cache line when the queue looks full or empty. The capacity is
+ *   rounded up to a power of two. The following functions are defined:
+ *
+ *     name name_new(usize cap);
+ *     name name_with_allocator(usize cap, const _VSTD_Allocator *allocator);
+ *     bool name_push(name *queue, T item);
+ *     usize name_push_n(name *queue, const T *items, usize count);
+ *     bool name_pop(name *queue, T *out);
+ *     usize name_pop_n(name *queue, T *out, usize count);
+ *     usize name_len(name *queue);
+ *     void name_free(name *queue);
+ *
+ *   push and pop return false when the queue is full or empty, push_n and
+ *   pop_n return the number of items actually pushed or popped.
+ *
+ * @param[in]
+ *   name : Name of the struct, also used as the prefix of the functions.
+ * @param[in]
+ *   T : Type of the queue's data.
+ *
+ * */
+#define VSTD_SPSC_QUEUE_DEFINE(name, T)                                        \
+  typedef struct name {                                                        \
+    _Alignas(VSTD_QUEUE_CACHE_LINE) _Atomic usize head;                        \
+    usize tail_cache;                                                          \
+    _Alignas(VSTD_QUEUE_CACHE_LINE) _Atomic usize tail;                        \
+    usize head_cache;                                                          \
+    _Alignas(VSTD_QUEUE_CACHE_LINE) T *ptr;                                    \
+    usize cap;                                                                 \
+    const _VSTD_Allocator *alloc;                                              \
+  } name;                                                                      \
+                                                                               \
+  VSTD_INLINE name name##_with_allocator(usize cap,                            \
+                                         const _VSTD_Allocator *allocator) {   \
+    cap = _vstd_deque_cap(cap);                                                \
+    name queue = (name){                                                       \
+        .tail_cache = 0,                                                       \
+        .head_cache = 0,                                                       \
+        .ptr = (T *)vstd_alloc(allocator, sizeof(T) * cap),                    \
+        .cap = cap,                                                            \
+        .alloc = allocator,                                                    \
+    };                                                                         \
+    atomic_init(&queue.head, 0);                                               \
+    atomic_init(&queue.tail, 0);                                               \
+    return queue;                                                              \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name name##_new(usize cap) {                                     \
+    return name##_with_allocator(cap, NULL);                                   \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE usize name##_push_n(name *queue, const T *items, usize count) {  \
+    usize tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);     \
+    usize free = queue->cap - (tail - queue->head_cache);                      \
+    if (free < count) {                                                        \
+      queue->head_cache =                                                      \
+          atomic_load_explicit(&queue->head, memory_order_acquire);            \
+      free = queue->cap - (tail - queue->head_cache);                          \
+      count = count < free ? count : free;                                     \
+    }                                                                          \
+    usize index = tail & (queue->cap - 1);                                     \
+    usize first = queue->cap - index < count ? queue->cap - index : count;     \
+    memcpy(queue->ptr + index, items, sizeof(T) * first);                      \
+    memcpy(queue->ptr, items + first, sizeof(T) * (count - first));            \
+    atomic_store_explicit(&queue->tail, tail + count, memory_order_release);   \
+    return count;                                                              \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE bool name##_push(name *queue, T item) {                          \
+    usize tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);     \
+    if (tail - queue->head_cache == queue->cap) {                              \
+      queue->head_cache =                                                      \
+          atomic_load_explicit(&queue->head, memory_order_acquire);            \
+      if (tail - queue->head_cache == queue->cap) {                            \
+        return false;                                                          \
+      }                                                                        \
+    }                                                                          \
+    queue->ptr[tail & (queue->cap - 1)] = item;                                \
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);       \
+    return true;                                                               \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE usize name##_pop_n(name *queue, T *out, usize count) {           \
+    usize head = atomic_load_explicit(&queue->head, memory_order_relaxed);     \
+    usize len = queue->tail_cache - head;                                      \
+    if (len < count) {                                                         \
+      queue->tail_cache =                                                      \
+          atomic_load_explicit(&queue->tail, memory_order_acquire);            \
+      len = queue->tail_cache - head;                                          \
+      count = count < len ? count : len;                                       \
+    }                                                                          \
+    usize index = head & (queue->cap - 1);                                     \
+    usize first = queue->cap - index < count ? queue->cap - index : count;     \
+    memcpy(out, queue->ptr + index, sizeof(T) * first);                        \
+    memcpy(out + first, queue->ptr, sizeof(T) * (count - first));              \
+    atomic_store_explicit(&queue->head, head + count, memory_order_release);   \
+    return count;                                                              \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE bool name##_pop(name *queue, T *out) {                           \
+    usize head = atomic_load_explicit(&queue->head, memory_order_relaxed);     \
+    if (head == queue->tail_cache) {                                           \
+      queue->tail_cache =                                                      \
+          atomic_load_explicit(&queue->tail, memory_order_acquire);            \
+      if (head == queue->tail_cache) {                                         \
+        return false;                                                          \
+      }                                                                        \
+    }                                                                          \
+    *out = queue->ptr[head & (queue->cap - 1)];                                \
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);       \
+    return true;                                                               \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE usize name##_len(name *queue) {                                  \
+    usize head = atomic_load_explicit(&queue->head, memory_order_acquire);     \
+    return atomic_load_explicit(&queue->tail, memory_order_acquire) - head;    \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_free(name *queue) {                                  \
+    vstd_free(queue->alloc, queue->ptr, sizeof(T) * queue->cap);               \
+    queue->ptr = NULL;                                                         \
+    queue->cap = 0;                                                            \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   VSTD_MPMC_QUEUE_DEFINE
+ *
+ * @description
+ *   Defines a bounded multi producer multi consumer queue struct with the
+ *   given name, and a name_cell struct for its items. Every cell holds a
+ *   sequence number, which tells the producers and the consumers whether the
+ *   cell is ready for them, so the threads only contend on the head or the
+ *   tail index. Batch operations claim a run of ready cells with a single
+ *   compare-and-swap. The capacity is rounded up to a power of two, and it's
+ *   at least 2. The following functions are defined:
+ *
+ *     name name_new(usize cap);
+ *     name name_with_allocator(usize cap, const _VSTD_Allocator *allocator);
+ *     bool name_push(name *queue, T item);
+ *     usize name_push_n(name *queue, const T *items, usize count);
+ *     bool name_pop(name *queue, T *out);
+ *     usize name_pop_n(name *queue, T *out, usize count);
+ *     usize name_len(name *queue);
+ *     void name_free(name *queue);
+ *
+ *   push and pop return false when the queue is full or empty, push_n and
+ *   pop_n return the number of items actually pushed or popped.
+ *
+ * @param[in]
+ *   name : Name of the struct, also used as the prefix of the functions.
+ * @param[in]
+ *   T : Type of the queue's data.
+ *
+ * */
+#define VSTD_MPMC_QUEUE_DEFINE(name, T)                                        \
+  typedef struct name##_cell {                                                 \
+    _Atomic usize seq;                                                         \
+    T data;                                                                    \
+  } name##_cell;                                                               \
+                                                                               \
+  typedef struct name {                                                        \
+    _Alignas(VSTD_QUEUE_CACHE_LINE) _Atomic usize head;                        \
+    _Alignas(VSTD_QUEUE_CACHE_LINE) _Atomic usize tail;                        \
+    _Alignas(VSTD_QUEUE_CACHE_LINE) name##_cell *cells;                        \
+    usize cap;                                                                 \
+    const _VSTD_Allocator *alloc;                                              \
+  } name;                                                                      \
+                                                                               \
+  VSTD_INLINE name name##_with_allocator(usize cap,                            \
+                                         const _VSTD_Allocator *allocator) {   \
+    cap = _vstd_deque_cap(cap < 2 ? 2 : cap);                                  \
+    name queue = (name){                                                       \
+        .cells = (name##_cell *)vstd_alloc(allocator,                          \
+                                           sizeof(name##_cell) * cap),         \
+        .cap = cap,                                                            \
+        .alloc = allocator,                                                    \
+    };                                                                         \
+    for (usize i = 0; i < cap; ++i) {                                          \
+      atomic_init(&queue.cells[i].seq, i);                                     \
+    }                                                                          \
+    atomic_init(&queue.head, 0);                                               \
+    atomic_init(&queue.tail, 0);                                               \
+    return queue;                                                              \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name name##_new(usize cap) {                                     \
+    return name##_with_allocator(cap, NULL);                                   \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC usize name##_push_n(name *queue, const T *items, usize count) {  \
+    usize mask = queue->cap - 1;                                               \
+    usize pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);      \
+    usize ready;                                                               \
+    do {                                                                       \
+      for (ready = 0; ready < count && ready < queue->cap; ++ready) {          \
+        usize seq = atomic_load_explicit(                                      \
+            &queue->cells[(pos + ready) & mask].seq, memory_order_acquire);    \
+        if (seq != pos + ready) {                                              \
+          break;                                                               \
+        }                                                                      \
+      }                                                                        \
+      if (ready == 0) {                                                        \
+        usize seq = atomic_load_explicit(&queue->cells[pos & mask].seq,        \
+                                         memory_order_acquire);                \
+        if ((isize)(seq - pos) < 0) {                                          \
+          return 0;                                                            \
+        }                                                                      \
+        pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);        \
+        continue;                                                              \
+      }                                                                        \
+    } while (ready == 0 ||                                                     \
+             !atomic_compare_exchange_weak_explicit(                           \
+                 &queue->tail, &pos, pos + ready, memory_order_relaxed,        \
+                 memory_order_relaxed));                                       \
+                                                                               \
+    for (usize i = 0; i < ready; ++i) {                                        \
+      name##_cell *cell = &queue->cells[(pos + i) & mask];                     \
+      cell->data = items[i];                                                   \
+      atomic_store_explicit(&cell->seq, pos + i + 1, memory_order_release);    \
+    }                                                                          \
+    return ready;                                                              \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE bool name##_push(name *queue, T item) {                          \
+    usize mask = queue->cap - 1;                                               \
+    usize pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);      \
+    name##_cell *cell;                                                         \
+    for (;;) {                                                                 \
+      cell = &queue->cells[pos & mask];                                        \
+      usize seq = atomic_load_explicit(&cell->seq, memory_order_acquire);      \
+      isize diff = (isize)(seq - pos);                                         \
+      if (diff == 0) {                                                         \
+        if (atomic_compare_exchange_weak_explicit(&queue->tail, &pos,          \
+                                                  pos + 1,                     \
+                                                  memory_order_relaxed,        \
+                                                  memory_order_relaxed)) {     \
+          break;                                                               \
+        }                                                                      \
+      } else if (diff < 0) {                                                   \
+        return false;                                                          \
+      } else {                                                                 \
+        pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);        \
+      }                                                                        \
+    }                                                                          \
+    cell->data = item;                                                         \
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);          \
+    return true;                                                               \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC usize name##_pop_n(name *queue, T *out, usize count) {           \
+    usize mask = queue->cap - 1;                                               \
+    usize pos = atomic_load_explicit(&queue->head, memory_order_relaxed);      \
+    usize ready;                                                               \
+    do {                                                                       \
+      for (ready = 0; ready < count && ready < queue->cap; ++ready) {          \
+        usize seq = atomic_load_explicit(                                      \
+            &queue->cells[(pos + ready) & mask].seq, memory_order_acquire);    \
+        if (seq != pos + ready + 1) {                                          \
+          break;                                                               \
+        }                                                                      \
+      }                                                                        \
+      if (ready == 0) {                                                        \
+        usize seq = atomic_load_explicit(&queue->cells[pos & mask].seq,        \
+                                         memory_order_acquire);                \
+        if ((isize)(seq - (pos + 1)) < 0) {                                    \
+          return 0;                                                            \
+        }                                                                      \
+        pos = atomic_load_explicit(&queue->head, memory_order_relaxed);        \
+        continue;                                                              \
+      }                                                                        \
+    } while (ready == 0 ||                                                     \
+             !atomic_compare_exchange_weak_explicit(                           \
+                 &queue->head, &pos, pos + ready, memory_order_relaxed,        \
+                 memory_order_relaxed));                                       \
+                                                                               \
+    for (usize i = 0; i < ready; ++i) {                                        \
+      name##_cell *cell = &queue->cells[(pos + i) & mask];                     \
+      out[i] = cell->data;                                                     \
+      atomic_store_explicit(&cell->seq, pos + i + mask + 1,                    \
+                            memory_order_release);                             \
+    }                                                                          \
+    return ready;                                                              \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE bool name##_pop(name *queue, T *out) {                           \
+    usize mask = queue->cap - 1;                                               \
+    usize pos = atomic_load_explicit(&queue->head, memory_order_relaxed);      \
+    name##_cell *cell;                                                         \
+    for (;;) {                                                                 \
+      cell = &queue->cells[pos & mask];                                        \
+      usize seq = atomic_load_explicit(&cell->seq, memory_order_acquire);      \
+      isize diff = (isize)(seq - (pos + 1));                                   \
+      if (diff == 0) {                                                         \
+        if (atomic_compare_exchange_weak_explicit(&queue->head, &pos,          \
+                                                  pos + 1,                     \
+                                                  memory_order_relaxed,        \
+                                                  memory_order_relaxed)) {     \
+          break;                                                               \
+        }                                                                      \
+      } else if (diff < 0) {                                                   \
+        return false;                                                          \
+      } else {                                                                 \
+        pos = atomic_load_explicit(&queue->head, memory_order_relaxed);        \
+      }                                                                        \
+    }                                                                          \
+    *out = cell->data;                                                         \
+    atomic_store_explicit(&cell->seq, pos + mask + 1, memory_order_release);   \
+    return true;                                                               \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE usize name##_len(name *queue) {                                  \
+    usize head = atomic_load_explicit(&queue->head, memory_order_acquire);     \
+    usize tail = atomic_load_explicit(&queue->tail, memory_order_acquire);     \
+    return tail > head ? tail - head : 0;                                      \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_free(name *queue) {                                  \
+    vstd_free(queue->alloc, queue->cells, sizeof(name##_cell) * queue->cap);   \
+    queue->cells = NULL;                                                       \
+    queue->cap = 0;                                                            \
+  }
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Bitset
+ *
+ * @description
+ *   Growable set of bits packed into 64 bit words. Set operations and counting
+ *   work a whole word at a time, and use AVX2 when it's enabled. Counting uses
+ *   __builtin_popcountll, which compiles to the POPCNT instruction when it's
+ *   enabled, for example with -mpopcnt.
+ *
+ * */
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_Bitset
+ *
+ * @description:
+ *   Bitset implementation, len is the number of bits and cap the number of
+ *   words ptr can hold. The bits of the last word past len are always 0.
+ *
+ * */
+struct _VSTD_Bitset {
+  u64 *ptr;
+  usize len;
+  usize cap;
+  const _VSTD_Allocator *alloc;
+};
+
+#ifdef VSTD_BITSET_STRIP_PREFIX
+typedef struct _VSTD_Bitset Bitset;
+#define _VSTD_Bitset Bitset
+#else
+typedef struct _VSTD_Bitset VSTD_Bitset;
+#define _VSTD_Bitset VSTD_Bitset
+#endif
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_bitset_words
+ *
+ * @description
+ *   Returns the number of words needed to hold the bits. This is a helper
+ *   function and it's only meant to be used the vstd library functions.
+ *
+ * @param[in]
+ *   bits : Number of bits.
+ *
+ * @return
+ *   Number of words.
+ *
+ * */
+VSTD_INLINE usize _vstd_bitset_words(usize bits) { return (bits + 63) / 64; }
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_with_allocator
+ *
+ * @description
+ *   Creates a new empty _VSTD_Bitset, which can hold the given number of bits
+ *   without reallocating, and is bound to the allocator.
+ *
+ * @param[in]
+ *   bits : Capacity of the bitset in bits.
+ * @param[in]
+ *   allocator : Pointer to the _VSTD_Allocator to bind the bitset to.
+ *
+ * @return
+ *   New empty _VSTD_Bitset.
+ *
+ * */
+VSTD_INLINE _VSTD_Bitset
+vstd_bitset_with_allocator(usize bits, const _VSTD_Allocator *allocator) {
+  usize cap = _vstd_bitset_words(bits);
+  cap = cap ? cap : 1;
+  return (_VSTD_Bitset){
+      .ptr = (u64 *)vstd_alloc_zeroed(allocator, sizeof(u64) * cap),
+      .len = 0,
+      .cap = cap,
+      .alloc = allocator,
+  };
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_with_capacity
+ *
+ * @description
+ *   Creates a new empty _VSTD_Bitset, which can hold the given number of bits
+ *   without reallocating.
+ *
+ * @param[in]
+ *   bits : Capacity of the bitset in bits.
+ *
+ * @return
+ *   New empty _VSTD_Bitset.
+ *
+ * */
+VSTD_INLINE _VSTD_Bitset vstd_bitset_with_capacity(usize bits) {
+  return vstd_bitset_with_allocator(bits, NULL);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_new
+ *
+ * @description
+ *   Creates a new empty _VSTD_Bitset, with a capacity of a single word.
+ *
+ * @return
+ *   New empty _VSTD_Bitset.
+ *
+ * */
+VSTD_INLINE _VSTD_Bitset vstd_bitset_new(void) {
+  return vstd_bitset_with_capacity(64);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_resize
+ *
+ * @description
+ *   Sets the number of bits in the bitset. New bits are 0, and the capacity
+ *   grows like a _VSTD_Vector's.
+ *
+ * @param[in]
+ *   bitset : Pointer to _VSTD_Bitset to modify.
+ * @param[in]
+ *   bits : New number of bits.
+ *
+ * */
+VSTD_STATIC void vstd_bitset_resize(_VSTD_Bitset *bitset, usize bits) {
+  usize words = _vstd_bitset_words(bits);
+  usize old_words = _vstd_bitset_words(bitset->len);
+
+  if (words > bitset->cap) {
+    usize cap = _vstd_vector_grow_cap(bitset->cap, words);
+    bitset->ptr = (u64 *)vstd_realloc(bitset->alloc, bitset->ptr,
+                                      sizeof(u64) * bitset->cap,
+                                      sizeof(u64) * cap);
+    bitset->cap = cap;
+  }
+  if (words > old_words) {
+    memset(bitset->ptr + old_words, 0, sizeof(u64) * (words - old_words));
+  }
+  if (bits < bitset->len && bits % 64) {
+    bitset->ptr[words - 1] &= ((u64)1 << (bits % 64)) - 1;
+  }
+
+  bitset->len = bits;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_set
+ *
+ * @description
+ *   Sets the bit at the given index to 1, the bitset grows if the index is out
+ *   of its range.
+ *
+ * @param[in]
+ *   bitset : Pointer to _VSTD_Bitset to modify.
+ * @param[in]
+ *   index : Index of the bit.
+ *
+ * */
+VSTD_INLINE void vstd_bitset_set(_VSTD_Bitset *bitset, usize index) {
+  if (index >= bitset->len) {
+    vstd_bitset_resize(bitset, index + 1);
+  }
+  bitset->ptr[index / 64] |= (u64)1 << (index % 64);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_unset
+ *
+ * @description
+ *   Sets the bit at the given index to 0, indices out of the bitset's range
+ *   are already 0.
+ *
+ * @param[in]
+ *   bitset : Pointer to _VSTD_Bitset to modify.
+ * @param[in]
+ *   index : Index of the bit.
+ *
+ * */
+VSTD_INLINE void vstd_bitset_unset(_VSTD_Bitset *bitset, usize index) {
+  if (index < bitset->len) {
+    bitset->ptr[index / 64] &= ~((u64)1 << (index % 64));
+  }
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_test
+ *
+ * @description
+ *   Checks the bit at the given index, indices out of the bitset's range are
+ *   0.
+ *
+ * @param[in]
+ *   bitset : Pointer to _VSTD_Bitset to check.
+ * @param[in]
+ *   index : Index of the bit.
+ *
+ * @return
+ *   true if the bit is 1, false otherwise.
+ *
+ * */
+VSTD_INLINE bool vstd_bitset_test(const _VSTD_Bitset *bitset, usize index) {
+  return index < bitset->len &&
+         (bitset->ptr[index / 64] >> (index % 64) & 1);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_clear
+ *
+ * @description
+ *   Removes every bit of the bitset, keeping its capacity.
+ *
+ * @param[in]
+ *   bitset : Pointer to _VSTD_Bitset to modify.
+ *
+ * */
+VSTD_INLINE void vstd_bitset_clear(_VSTD_Bitset *bitset) {
+  memset(bitset->ptr, 0, sizeof(u64) * _vstd_bitset_words(bitset->len));
+  bitset->len = 0;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_free
+ *
+ * @description
+ *   Frees the underlying pointer of the given _VSTD_Bitset.
+ *
+ * @param[in]
+ *   bitset : Pointer to _VSTD_Bitset to free.
+ *
+ * */
+VSTD_INLINE void vstd_bitset_free(_VSTD_Bitset *bitset) {
+  vstd_free(bitset->alloc, bitset->ptr, sizeof(u64) * bitset->cap);
+  bitset->ptr = NULL;
+  bitset->len = 0;
+  bitset->cap = 0;
+}
+
+/*****************************************************************************
+ *
+ * @macro
+ *   _VSTD_BITSET_LOOP
+ *
+ * @description
+ *   Applies a word operation to the first words of dst and src, four words at
+ *   a time with AVX2 when it's enabled. simd is the AVX2 intrinsic and op the
+ *   scalar operator, both applied as dst op src. This is a helper macro and
+ *   it's only meant to be used the vstd library functions.
+ *
+ * */
+#if defined(__AVX2__)
+#define _vstd_simd_andnot(a, b) _mm256_andnot_si256(b, a)
+#define _VSTD_BITSET_LOOP(dst, src, words, simd, op)                           \
+  do {                                                                         \
+    usize _i = 0;                                                              \
+    for (; _i + 4 <= (words); _i += 4) {                                       \
+      __m256i _a = _mm256_loadu_si256((const __m256i *)((dst) + _i));          \
+      __m256i _b = _mm256_loadu_si256((const __m256i *)((src) + _i));          \
+      _mm256_storeu_si256((__m256i *)((dst) + _i), simd(_a, _b));              \
+    }                                                                          \
+    for (; _i < (words); ++_i) {                                               \
+      (dst)[_i] = (dst)[_i] op(src)[_i];                                       \
+    }                                                                          \
+  } while (0)
+#else
+#define _VSTD_BITSET_LOOP(dst, src, words, simd, op)                           \
+  do {                                                                         \
+    for (usize _i = 0; _i < (words); ++_i) {                                   \
+      (dst)[_i] = (dst)[_i] op(src)[_i];                                       \
+    }                                                                          \
+  } while (0)
+#endif
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_or
+ *
+ * @description
+ *   Sets every bit of dst that is set in src, dst grows to src's length if
+ *   it's shorter.
+ *
+ * @param[in]
+ *   dst : Pointer to _VSTD_Bitset to modify.
+ * @param[in]
+ *   src : Pointer to _VSTD_Bitset to read.
+ *
+ * */
+VSTD_STATIC void vstd_bitset_or(_VSTD_Bitset *dst, const _VSTD_Bitset *src) {
+  if (src->len > dst->len) {
+    vstd_bitset_resize(dst, src->len);
+  }
+  _VSTD_BITSET_LOOP(dst->ptr, src->ptr, _vstd_bitset_words(src->len),
+                    _mm256_or_si256, |);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_xor
+ *
+ * @description
+ *   Flips every bit of dst that is set in src, dst grows to src's length if
+ *   it's shorter.
+ *
+ * @param[in]
+ *   dst : Pointer to _VSTD_Bitset to modify.
+ * @param[in]
+ *   src : Pointer to _VSTD_Bitset to read.
+ *
+ * */
+VSTD_STATIC void vstd_bitset_xor(_VSTD_Bitset *dst, const _VSTD_Bitset *src) {
+  if (src->len > dst->len) {
+    vstd_bitset_resize(dst, src->len);
+  }
+  _VSTD_BITSET_LOOP(dst->ptr, src->ptr, _vstd_bitset_words(src->len),
+                    _mm256_xor_si256, ^);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_and
+ *
+ * @description
+ *   Unsets every bit of dst that isn't set in src, including the bits past
+ *   src's length.
+ *
+ * @param[in]
+ *   dst : Pointer to _VSTD_Bitset to modify.
+ * @param[in]
+ *   src : Pointer to _VSTD_Bitset to read.
+ *
+ * */
+VSTD_STATIC void vstd_bitset_and(_VSTD_Bitset *dst, const _VSTD_Bitset *src) {
+  usize words = _vstd_bitset_words(dst->len);
+  usize src_words = _vstd_bitset_words(src->len);
+  if (src_words < words) {
+    memset(dst->ptr + src_words, 0, sizeof(u64) * (words - src_words));
+    words = src_words;
+  }
+  _VSTD_BITSET_LOOP(dst->ptr, src->ptr, words, _mm256_and_si256, &);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_andnot
+ *
+ * @description
+ *   Unsets every bit of dst that is set in src.
+ *
+ * @param[in]
+ *   dst : Pointer to _VSTD_Bitset to modify.
+ * @param[in]
+ *   src : Pointer to _VSTD_Bitset to read.
+ *
+ * */
+VSTD_STATIC void vstd_bitset_andnot(_VSTD_Bitset *dst,
+                                    const _VSTD_Bitset *src) {
+  usize words = _vstd_bitset_words(dst->len);
+  usize src_words = _vstd_bitset_words(src->len);
+  words = src_words < words ? src_words : words;
+  _VSTD_BITSET_LOOP(dst->ptr, src->ptr, words, _vstd_simd_andnot, &~);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_count
+ *
+ * @description
+ *   Counts the set bits of the bitset. With AVX2, four words are counted at a
+ *   time with a nibble lookup table, and the sums are accumulated with
+ *   _mm256_sad_epu8.
+ *
+ * @param[in]
+ *   bitset : Pointer to _VSTD_Bitset to count.
+ *
+ * @return
+ *   Number of set bits.
+ *
+ * */
+VSTD_STATIC usize vstd_bitset_count(const _VSTD_Bitset *bitset) {
+  usize words = _vstd_bitset_words(bitset->len);
+  const u64 *ptr = bitset->ptr;
+  usize count = 0, i = 0;
+
+#if defined(__AVX2__)
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1,
+                       2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low = _mm256_set1_epi8(0x0f);
+  __m256i total = _mm256_setzero_si256();
+  for (; i + 4 <= words; i += 4) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(ptr + i));
+    __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+    __m256i hi = _mm256_shuffle_epi8(
+        lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+    total = _mm256_add_epi64(
+        total,
+        _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+  }
+  count += (usize)_mm256_extract_epi64(total, 0) +
+           (usize)_mm256_extract_epi64(total, 1) +
+           (usize)_mm256_extract_epi64(total, 2) +
+           (usize)_mm256_extract_epi64(total, 3);
+#endif
+
+  for (; i < words; ++i) {
+    count += (usize)__builtin_popcountll(ptr[i]);
+  }
+  return count;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_bitset_next
+ *
+ * @description
+ *   Finds the first set bit at or after the given index.
+ *
+ * @param[in]
+ *   bitset : Pointer to _VSTD_Bitset to search.
+ * @param[in]
+ *   from : Index to start searching from.
+ *
+ * @return
+ *   Index of the set bit, or the bitset's length if there's none.
+ *
+ * */
+VSTD_STATIC usize vstd_bitset_next(const _VSTD_Bitset *bitset, usize from) {
+  if (from >= bitset->len) {
+    return bitset->len;
+  }
+
+  usize words = _vstd_bitset_words(bitset->len);
+  usize word = from / 64;
+  u64 bits = bitset->ptr[word] & (~(u64)0 << (from % 64));
+  while (!bits) {
+    if (++word == words) {
+      return bitset->len;
+    }
+    bits = bitset->ptr[word];
+  }
+  return word * 64 + (usize)__builtin_ctzll(bits);
+}
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_bitset_iter
+ *
+ * @description
+ *   Helper function to easily iterate trough the set bits of the _VSTD_Bitset
+ *   in order, skipping the unset ones a word at a time. In every iteration it
+ *   is possible to access the index of the current bit from _$i.
+ *
+ * @param[in]
+ *   bitset : _VSTD_Bitset to iterate.
+ * @param[in]
+ *   ... : A single function or a block of code to execute every iteration.
+ *
+ * */
+#define vstd_bitset_iter(bitset, ...)                                          \
+  do {                                                                         \
+    usize _$words = _vstd_bitset_words((bitset).len);                          \
+    for (usize _$word = 0; _$word < _$words; ++_$word) {                       \
+      for (u64 _$bits = (bitset).ptr[_$word]; _$bits; _$bits &= _$bits - 1) {  \
+        usize _$i = _$word * 64 + (usize)__builtin_ctzll(_$bits);              \
+        __VA_ARGS__;                                                           \
+        (void)(_$i);                                                           \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Arena
+ *
+ * @description
+ *   Bump allocator for short lived objects. Memory is carved out of large
+ *   chunks, individual allocations are never freed, instead the whole arena is
+ *   reset at once, or rolled back to a previously saved mark. Chunks are kept
+ *   on reset and reused, so a warmed up arena doesn't touch the heap at all.
+ *
+ * */
+
+#ifndef VSTD_ARENA_CHUNK_SIZE
+#define VSTD_ARENA_CHUNK_SIZE (64 * 1024)
+#endif
+
+#define VSTD_ARENA_ALIGNMENT _Alignof(max_align_t)
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_ArenaChunk
+ *
+ * @description:
+ *   Header of a single chunk of an arena, the chunk's memory follows it. This
+ *   is a helper type and it's only meant to be used the vstd library functions.
+ *
+ * */
+struct _VSTD_ArenaChunk {
+  struct _VSTD_ArenaChunk *next;
+  usize cap;
+  usize used;
+};
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_Arena
+ *
+ * @description:
+ *   Arena allocator, chunks are linked in the order they are used in, chunk
+ *   points to the one currently being allocated from. last is the most recent
+ *   allocation, which can still be grown or freed in place. A zero initialized
+ *   _VSTD_Arena is a valid empty arena with the default chunk size.
+ *
+ * */
+struct _VSTD_Arena {
+  struct _VSTD_ArenaChunk *first;
+  struct _VSTD_ArenaChunk *chunk;
+  usize chunk_size;
+  void *last;
+  _VSTD_Allocator allocator;
+};
+
+#ifdef VSTD_ARENA_STRIP_PREFIX
+typedef struct _VSTD_Arena Arena;
+#define _VSTD_Arena Arena
+#else
+typedef struct _VSTD_Arena VSTD_Arena;
+#define _VSTD_Arena VSTD_Arena
+#endif
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_ArenaMark
+ *
+ * @description:
+ *   Position inside of a _VSTD_Arena, returned by vstd_arena_save.
+ *
+ * */
+struct _VSTD_ArenaMark {
+  struct _VSTD_ArenaChunk *chunk;
+  usize used;
+};
+
+#ifdef VSTD_ARENA_STRIP_PREFIX
+typedef struct _VSTD_ArenaMark ArenaMark;
+#define _VSTD_ArenaMark ArenaMark
+#else
+typedef struct _VSTD_ArenaMark VSTD_ArenaMark;
+#define _VSTD_ArenaMark VSTD_ArenaMark
+#endif
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_arena_chunk_data
+ *
+ * @description
+ *   Returns the memory of the chunk. This is a helper function and it's only
+ *   meant to be used the vstd library functions.
+ *
+ * @param[in]
+ *   chunk : Chunk to access.
+ *
+ * @return
+ *   Pointer to the first byte after the chunk's header.
+ *
+ * */
+VSTD_INLINE u8 *_vstd_arena_chunk_data(struct _VSTD_ArenaChunk *chunk) {
+  return (u8 *)(chunk + 1);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_new
+ *
+ * @description
+ *   Creates a new empty _VSTD_Arena, no memory is allocated until the first
+ *   allocation is made.
+ *
+ * @param[in]
+ *   chunk_size : Minimum size of the chunks in bytes, or 0 for
+ *                VSTD_ARENA_CHUNK_SIZE.
+ *
+ * @return
+ *   New empty _VSTD_Arena.
+ *
+ * */
+VSTD_INLINE _VSTD_Arena vstd_arena_new(usize chunk_size) {
+  return (_VSTD_Arena){
+      .first = NULL,
+      .chunk = NULL,
+      .chunk_size = chunk_size,
+      .last = NULL,
+  };
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_alloc_aligned
+ *
+ * @description
+ *   Allocates a block of memory from the arena, with the given alignment. The
+ *   chunks after the current one are reused if the block fits them, otherwise
+ *   a new chunk is allocated and linked after the current one.
+ *
+ * @param[in]
+ *   arena : _VSTD_Arena to allocate from.
+ * @param[in]
+ *   size : Size of the block in bytes.
+ * @param[in]
+ *   align : Alignment of the block, has to be a power of two.
+ *
+ * @return
+ *   Pointer to the allocated block.
+ *
+ * */
+VSTD_STATIC void *vstd_arena_alloc_aligned(_VSTD_Arena *arena, usize size,
+                                           usize align) {
+  for (struct _VSTD_ArenaChunk *chunk = arena->chunk; chunk;
+       chunk = chunk->next) {
+    if (chunk != arena->chunk) {
+      chunk->used = 0;
+    }
+
+    uptr base = (uptr)_vstd_arena_chunk_data(chunk);
+    uptr start = (base + chunk->used + align - 1) & ~(uptr)(align - 1);
+    if (start - base + size <= chunk->cap) {
+      chunk->used = start - base + size;
+      arena->chunk = chunk;
+      arena->last = (void *)start;
+      return arena->last;
+    }
+  }
+
+  usize cap = arena->chunk_size ? arena->chunk_size : VSTD_ARENA_CHUNK_SIZE;
+  if (cap < size + align) {
+    cap = size + align;
+  }
+
+  struct _VSTD_ArenaChunk *chunk = (struct _VSTD_ArenaChunk *)VSTD_MALLOC(
+      sizeof(struct _VSTD_ArenaChunk) + cap);
+  chunk->cap = cap;
+
+  if (arena->chunk) {
+    chunk->next = arena->chunk->next;
+    arena->chunk->next = chunk;
+  } else {
+    chunk->next = arena->first;
+    arena->first = chunk;
+  }
+
+  uptr base = (uptr)_vstd_arena_chunk_data(chunk);
+  uptr start = (base + align - 1) & ~(uptr)(align - 1);
+  chunk->used = start - base + size;
+  arena->chunk = chunk;
+  arena->last = (void *)start;
+  return arena->last;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_alloc
+ *
+ * @description
+ *   Allocates a block of memory from the arena, aligned for any type.
+ *
+ * @param[in]
+ *   arena : _VSTD_Arena to allocate from.
+ * @param[in]
+ *   size : Size of the block in bytes.
+ *
+ * @return
+ *   Pointer to the allocated block.
+ *
+ * */
+VSTD_INLINE void *vstd_arena_alloc(_VSTD_Arena *arena, usize size) {
+  return vstd_arena_alloc_aligned(arena, size, VSTD_ARENA_ALIGNMENT);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_realloc
+ *
+ * @description
+ *   Resizes a block of memory allocated from the arena. If the block is the
+ *   last allocation and still fits its chunk, it's resized in place, otherwise
+ *   a new block is allocated and the contents are copied to it.
+ *
+ * @param[in]
+ *   arena : _VSTD_Arena the block was allocated from.
+ * @param[in]
+ *   ptr : Pointer to the block, or NULL.
+ * @param[in]
+ *   old_size : Current size of the block in bytes.
+ * @param[in]
+ *   new_size : New size of the block in bytes.
+ *
+ * @return
+ *   Pointer to the resized block.
+ *
+ * */
+VSTD_STATIC void *vstd_arena_realloc(_VSTD_Arena *arena, void *ptr,
+                                     usize old_size, usize new_size) {
+  if (!ptr) {
+    return vstd_arena_alloc(arena, new_size);
+  }
+
+  if (ptr == arena->last) {
+    usize offset = (u8 *)ptr - _vstd_arena_chunk_data(arena->chunk);
+    if (offset + new_size <= arena->chunk->cap) {
+      arena->chunk->used = offset + new_size;
+      return ptr;
+    }
+  }
+
+  if (new_size <= old_size) {
+    return ptr;
+  }
+
+  void *block = vstd_arena_alloc(arena, new_size);
+  memcpy(block, ptr, old_size);
+  return block;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_free
+ *
+ * @description
+ *   Frees a block of memory allocated from the arena. Only the last allocation
+ *   is actually given back to the arena, freeing any other block does nothing.
+ *
+ * @param[in]
+ *   arena : _VSTD_Arena the block was allocated from.
+ * @param[in]
+ *   ptr : Pointer to the block.
+ *
+ * */
+VSTD_INLINE void vstd_arena_free(_VSTD_Arena *arena, void *ptr) {
+  if (ptr && ptr == arena->last) {
+    arena->chunk->used = (u8 *)ptr - _vstd_arena_chunk_data(arena->chunk);
+    arena->last = NULL;
+  }
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_save
+ *
+ * @description
+ *   Saves the current position of the arena, so every allocation made after
+ *   this call can be released at once with vstd_arena_restore.
+ *
+ * @param[in]
+ *   arena : _VSTD_Arena to save.
+ *
+ * @return
+ *   _VSTD_ArenaMark of the current position.
+ *
+ * */
+VSTD_INLINE _VSTD_ArenaMark vstd_arena_save(const _VSTD_Arena *arena) {
+  return (_VSTD_ArenaMark){
+      .chunk = arena->chunk,
+      .used = arena->chunk ? arena->chunk->used : 0,
+  };
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_restore
+ *
+ * @description
+ *   Rolls the arena back to a saved position, releasing every allocation made
+ *   after the mark was saved in O(1). Chunks are kept for reuse.
+ *
+ * @param[in]
+ *   arena : _VSTD_Arena to restore.
+ * @param[in]
+ *   mark : _VSTD_ArenaMark returned by vstd_arena_save.
+ *
+ * */
+VSTD_INLINE void vstd_arena_restore(_VSTD_Arena *arena, _VSTD_ArenaMark mark) {
+  arena->chunk = mark.chunk ? mark.chunk : arena->first;
+  if (arena->chunk) {
+    arena->chunk->used = mark.used;
+  }
+  arena->last = NULL;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_reset
+ *
+ * @description
+ *   Releases every allocation made from the arena in O(1). Chunks are kept and
+ *   reused by the following allocations.
+ *
+ * @param[in]
+ *   arena : _VSTD_Arena to reset.
+ *
+ * */
+VSTD_INLINE void vstd_arena_reset(_VSTD_Arena *arena) {
+  vstd_arena_restore(arena, (_VSTD_ArenaMark){.chunk = NULL, .used = 0});
+}
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_arena_scope
+ *
+ * @description
+ *   Runs the given code, and then releases every allocation it made from the
+ *   arena. The code shouldn't leave the scope with break, goto or return.
+ *
+ * @param[in]
+ *   arena : Pointer to the _VSTD_Arena.
+ * @param[in]
+ *   ... : Code to run.
+ *
+ * */
+#define vstd_arena_scope(arena, ...)                                           \
+  do {                                                                         \
+    _VSTD_ArenaMark _$mark = vstd_arena_save(arena);                           \
+    __VA_ARGS__;                                                               \
+    vstd_arena_restore(arena, _$mark);                                         \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_free_all
+ *
+ * @description
+ *   Frees every chunk of the arena, and resets it to an empty _VSTD_Arena.
+ *
+ * @param[in]
+ *   arena : _VSTD_Arena to free.
+ *
+ * */
+VSTD_STATIC void vstd_arena_free_all(_VSTD_Arena *arena) {
+  for (struct _VSTD_ArenaChunk *chunk = arena->first; chunk;) {
+    struct _VSTD_ArenaChunk *next = chunk->next;
+    VSTD_FREE(chunk);
+    chunk = next;
+  }
+  *arena = vstd_arena_new(arena->chunk_size);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_arena_allocator_alloc
+ *
+ * @description
+ *   _VSTD_Allocator alloc entry of an arena. This is a helper function and
+ *   it's only meant to be used the vstd library functions.
+ *
+ * */
+VSTD_STATIC void *_vstd_arena_allocator_alloc(void *ctx, usize size) {
+  return vstd_arena_alloc((_VSTD_Arena *)ctx, size);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_arena_allocator_realloc
+ *
+ * @description
+ *   _VSTD_Allocator realloc entry of an arena. This is a helper function and
+ *   it's only meant to be used the vstd library functions.
+ *
+ * */
+VSTD_STATIC void *_vstd_arena_allocator_realloc(void *ctx, void *ptr,
+                                                usize old_size,
+                                                usize new_size) {
+  return vstd_arena_realloc((_VSTD_Arena *)ctx, ptr, old_size, new_size);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_arena_allocator_free
+ *
+ * @description
+ *   _VSTD_Allocator free entry of an arena. This is a helper function and
+ *   it's only meant to be used the vstd library functions.
+ *
+ * */
+VSTD_STATIC void _vstd_arena_allocator_free(void *ctx, void *ptr,
+                                            usize size) {
+  (void)size;
+  vstd_arena_free((_VSTD_Arena *)ctx, ptr);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_allocator
+ *
+ * @description
+ *   Returns a _VSTD_Allocator backed by the arena, which can be used to bind
+ *   containers to it. Containers bound to an arena don't need to be freed, and
+ *   the arena shouldn't be moved while they're alive.
+ *
+ * @param[in]
+ *   arena : _VSTD_Arena to allocate from.
+ *
+ * @return
+ *   Pointer to the arena's _VSTD_Allocator.
+ *
+ * */
+VSTD_INLINE const _VSTD_Allocator *vstd_arena_allocator(_VSTD_Arena *arena) {
+  arena->allocator = (_VSTD_Allocator){
+      .ctx = arena,
+      .alloc = _vstd_arena_allocator_alloc,
+      .realloc = _vstd_arena_allocator_realloc,
+      .free = _vstd_arena_allocator_free,
+  };
+  return &arena->allocator;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_string_with_capacity
+ *
+ * @description
+ *   Creates a new empty _VSTD_String with the given capacity, which is
+ *   allocated from the arena.
+ *
+ * @param[in]
+ *   arena : _VSTD_Arena to allocate from.
+ * @param[in]
+ *   cap : Capacity for the new _VSTD_String.
+ *
+ * @return
+ *   New empty _VSTD_String bound to the arena.
+ *
+ * */
+VSTD_INLINE _VSTD_String vstd_arena_string_with_capacity(_VSTD_Arena *arena,
+                                                         usize cap) {
+  return vstd_string_with_allocator(cap, vstd_arena_allocator(arena));
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_string_from
+ *
+ * @description
+ *   Creates a new _VSTD_String from a C string, which is allocated from the
+ *   arena.
+ *
+ * @param[in]
+ *   arena : _VSTD_Arena to allocate from.
+ * @param[in]
+ *   str : C string to copy.
+ *
+ * @return
+ *   New _VSTD_String bound to the arena.
+ *
+ * */
+VSTD_STATIC _VSTD_String vstd_arena_string_from(_VSTD_Arena *arena,
+                                                const char *str) {
+  usize len = strlen(str);
+  _VSTD_String s = vstd_arena_string_with_capacity(arena, len + 1);
+
+  memcpy(vstd_string_ptr(&s), str, sizeof(char) * (len + 1));
+  _vstd_string_set_len(&s, len);
+
+  return s;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_arena_string_from_view
+ *
+ * @description
+ *   Creates a new _VSTD_String from a _VSTD_StrView, which is allocated from
+ *   the arena.
+ *
+ * @param[in]
+ *   arena : _VSTD_Arena to allocate from.
+ * @param[in]
+ *   view : _VSTD_StrView to copy.
+ *
+ * @return
+ *   New _VSTD_String bound to the arena.
+ *
+ * */
+VSTD_STATIC _VSTD_String vstd_arena_string_from_view(_VSTD_Arena *arena,
+                                                     _VSTD_StrView view) {
+  _VSTD_String s = vstd_arena_string_with_capacity(arena, view.len + 1);
+
+  char *ptr = vstd_string_ptr(&s);
+  memcpy(ptr, view.ptr, sizeof(char) * view.len);
+  ptr[view.len] = '\0';
+  _vstd_string_set_len(&s, view.len);
+
+  return s;
+}
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_arena_vector_with_capacity
+ *
+ * @description
+ *   Creates a new empty _VSTD_Vector with the given capacity, which is
+ *   allocated from the arena.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   capacity : Capacity of the new _VSTD_Vector.
+ * @param[in]
+ *   arena : Pointer to the _VSTD_Arena to allocate from.
+ *
+ * @return
+ *   New empty _VSTD_Vector bound to the arena.
+ *
+ * */
+#define vstd_arena_vector_with_capacity(type, capacity, arena)                 \
+  vstd_vector_with_allocator(type, capacity, vstd_arena_allocator(arena))
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_arena_vector_new
+ *
+ * @description
+ *   Creates a new empty _VSTD_Vector, which is allocated from the arena.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   arena : Pointer to the _VSTD_Arena to allocate from.
+ *
+ * @return
+ *   New empty _VSTD_Vector bound to the arena.
+ *
+ * */
+#define vstd_arena_vector_new(type, arena)                                     \
+  vstd_arena_vector_with_capacity(type, VSTD_VECTOR_INITIAL_CAP, arena)
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Pool
+ *
+ * @description
+ *   Fixed size object pool. Blocks are cut out of large slabs, every block is
+ *   aligned to VSTD_POOL_ALIGNMENT, and freed blocks are kept on a free list,
+ *   so both allocation and freeing are O(1). The pool is guarded by a spinlock,
+ *   threads allocating a lot can put a _VSTD_PoolCache in front of it, which
+ *   only takes the lock once per batch of blocks.
+ *
+ * */
+
+#ifndef VSTD_POOL_SLAB_SIZE
+#define VSTD_POOL_SLAB_SIZE (64 * 1024)
+#endif
+
+#ifndef VSTD_POOL_ALIGNMENT
+#define VSTD_POOL_ALIGNMENT 64
+#endif
+
+#ifndef VSTD_POOL_CACHE_CAP
+#define VSTD_POOL_CACHE_CAP 64
+#endif
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_PoolBlock
+ *
+ * @description:
+ *   Free block of a pool, linking to the next free block. Slabs start with the
+ *   same header, linking to the next slab. This is a helper type and it's only
+ *   meant to be used the vstd library functions.
+ *
+ * */
+struct _VSTD_PoolBlock {
+  struct _VSTD_PoolBlock *next;
+};
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_Pool
+ *
+ * @description:
+ *   Fixed size object pool. Blocks of the newest slab are handed out from
+ *   bump until they run out, and freed blocks are pushed to free_list. live
+ *   counts the blocks that are not owned by the pool, peak is the highest
+ *   value live has ever had.
+ *
+ * */
+struct _VSTD_Pool {
+  usize block_size;
+  usize slab_size;
+  struct _VSTD_PoolBlock *slabs;
+  struct _VSTD_PoolBlock *free_list;
+  u8 *bump;
+  u8 *bump_end;
+  usize live;
+  usize peak;
+  usize capacity;
+  atomic_flag lock;
+  _VSTD_Allocator allocator;
+};
+
+#ifdef VSTD_POOL_STRIP_PREFIX
+typedef struct _VSTD_Pool Pool;
+#define _VSTD_Pool Pool
+#else
+typedef struct _VSTD_Pool VSTD_Pool;
+#define _VSTD_Pool VSTD_Pool
+#endif
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_PoolCache
+ *
+ * @description:
+ *   Front-end of a _VSTD_Pool, which keeps up to VSTD_POOL_CACHE_CAP free
+ *   blocks of its own. A cache must only be used by a single thread, so it's
+ *   usually declared _Thread_local.
+ *
+ * */
+struct _VSTD_PoolCache {
+  _VSTD_Pool *pool;
+  struct _VSTD_PoolBlock *head;
+  usize count;
+};
+
+#ifdef VSTD_POOL_STRIP_PREFIX
+typedef struct _VSTD_PoolCache PoolCache;
+#define _VSTD_PoolCache PoolCache
+#else
+typedef struct _VSTD_PoolCache VSTD_PoolCache;
+#define _VSTD_PoolCache VSTD_PoolCache
+#endif
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_PoolStats
+ *
+ * @description:
+ *   Statistics of a _VSTD_Pool. Blocks held by a _VSTD_PoolCache are counted
+ *   as live, capacity is the number of blocks the slabs can hold.
+ *
+ * */
+struct _VSTD_PoolStats {
+  usize live;
+  usize peak;
+  usize capacity;
+};
+
+#ifdef VSTD_POOL_STRIP_PREFIX
+typedef struct _VSTD_PoolStats PoolStats;
+#define _VSTD_PoolStats PoolStats
+#else
+typedef struct _VSTD_PoolStats VSTD_PoolStats;
+#define _VSTD_PoolStats VSTD_PoolStats
+#endif
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_pool_lock
+ *
+ * @description
+ *   Spins until the pool's lock is acquired. This is a helper function and
+ *   it's only meant to be used the vstd library functions.
+ *
+ * @param[in]
+ *   pool : _VSTD_Pool to lock.
+ *
+ * */
+VSTD_INLINE void _vstd_pool_lock(_VSTD_Pool *pool) {
+  while (atomic_flag_test_and_set_explicit(&pool->lock, memory_order_acquire)) {
+#if defined(__SSE2__)
+    _mm_pause();
+#endif
+  }
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_pool_unlock
+ *
+ * @description
+ *   Releases the pool's lock. This is a helper function and it's only meant to
+ *   be used the vstd library functions.
+ *
+ * @param[in]
+ *   pool : _VSTD_Pool to unlock.
+ *
+ * */
+VSTD_INLINE void _vstd_pool_unlock(_VSTD_Pool *pool) {
+  atomic_flag_clear_explicit(&pool->lock, memory_order_release);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_pool_new
+ *
+ * @description
+ *   Creates a new empty _VSTD_Pool, no memory is allocated until the first
+ *   block is allocated. Block size is rounded up to VSTD_POOL_ALIGNMENT.
+ *
+ * @param[in]
+ *   block_size : Size of the blocks in bytes.
+ *
+ * @return
+ *   New empty _VSTD_Pool.
+ *
+ * */
+VSTD_STATIC _VSTD_Pool vstd_pool_new(usize block_size) {
+  if (block_size < sizeof(struct _VSTD_PoolBlock)) {
+    block_size = sizeof(struct _VSTD_PoolBlock);
+  }
+  block_size = (block_size + VSTD_POOL_ALIGNMENT - 1) &
+               ~(usize)(VSTD_POOL_ALIGNMENT - 1);
+
+  _VSTD_Pool pool = (_VSTD_Pool){
+      .block_size = block_size,
+      .slab_size =
+          block_size > VSTD_POOL_SLAB_SIZE ? block_size : VSTD_POOL_SLAB_SIZE,
+      .slabs = NULL,
+      .free_list = NULL,
+      .bump = NULL,
+      .bump_end = NULL,
+      .live = 0,
+      .peak = 0,
+      .capacity = 0,
+  };
+  atomic_flag_clear(&pool.lock);
+
+  return pool;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_pool_take
+ *
+ * @description
+ *   Takes a block from the free list, or from the newest slab, allocating a
+ *   new slab if needed. The caller has to hold the pool's lock. This is a
+ *   helper function and it's only meant to be used the vstd library functions.
+ *
+ * @param[in]
+ *   pool : _VSTD_Pool to take from.
+ *
+ * @return
+ *   Pointer to the block.
+ *
+ * */
+VSTD_STATIC void *_vstd_pool_take(_VSTD_Pool *pool) {
+  struct _VSTD_PoolBlock *block = pool->free_list;
+  if (block) {
+    pool->free_list = block->next;
+    return block;
+  }
+
+  if (pool->bump == pool->bump_end) {
+    usize header = sizeof(struct _VSTD_PoolBlock);
+    u8 *raw = (u8 *)VSTD_MALLOC(header + VSTD_POOL_ALIGNMENT + pool->slab_size);
+
+    struct _VSTD_PoolBlock *slab = (struct _VSTD_PoolBlock *)raw;
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+
+    uptr start = ((uptr)(raw + header) + VSTD_POOL_ALIGNMENT - 1) &
+                 ~(uptr)(VSTD_POOL_ALIGNMENT - 1);
+    usize count = pool->slab_size / pool->block_size;
+    pool->bump = (u8 *)start;
+    pool->bump_end = pool->bump + count * pool->block_size;
+    pool->capacity += count;
+  }
+
+  void *ptr = pool->bump;
+  pool->bump += pool->block_size;
+  return ptr;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_pool_alloc
+ *
+ * @description
+ *   Allocates a block from the pool in O(1).
+ *
+ * @param[in]
+ *   pool : _VSTD_Pool to allocate from.
+ *
+ * @return
+ *   Pointer to the block, aligned to VSTD_POOL_ALIGNMENT.
+ *
+ * */
+VSTD_STATIC void *vstd_pool_alloc(_VSTD_Pool *pool) {
+  _vstd_pool_lock(pool);
+
+  void *ptr = _vstd_pool_take(pool);
+  if (++pool->live > pool->peak) {
+    pool->peak = pool->live;
+  }
+
+  _vstd_pool_unlock(pool);
+  return ptr;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_pool_free
+ *
+ * @description
+ *   Gives a block back to the pool in O(1).
+ *
+ * @param[in]
+ *   pool : _VSTD_Pool the block was allocated from.
+ * @param[in]
+ *   ptr : Pointer to the block, or NULL.
+ *
+ * */
+VSTD_STATIC void vstd_pool_free(_VSTD_Pool *pool, void *ptr) {
+  if (!ptr) {
+    return;
+  }
+
+  struct _VSTD_PoolBlock *block = (struct _VSTD_PoolBlock *)ptr;
+
+  _vstd_pool_lock(pool);
+  block->next = pool->free_list;
+  pool->free_list = block;
+  pool->live--;
+  _vstd_pool_unlock(pool);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_pool_stats
+ *
+ * @description
+ *   Returns the statistics of the pool.
+ *
+ * @param[in]
+ *   pool : _VSTD_Pool to inspect.
+ *
+ * @return
+ *   _VSTD_PoolStats of the pool.
+ *
+ * */
+VSTD_STATIC _VSTD_PoolStats vstd_pool_stats(_VSTD_Pool *pool) {
+  _vstd_pool_lock(pool);
+  _VSTD_PoolStats stats = (_VSTD_PoolStats){
+      .live = pool->live,
+      .peak = pool->peak,
+      .capacity = pool->capacity,
+  };
+  _vstd_pool_unlock(pool);
+
+  return stats;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_pool_free_all
+ *
+ * @description
+ *   Frees every slab of the pool, and resets it to an empty _VSTD_Pool. Every
+ *   _VSTD_PoolCache of the pool has to be flushed before.
+ *
+ * @param[in]
+ *   pool : _VSTD_Pool to free.
+ *
+ * */
+VSTD_STATIC void vstd_pool_free_all(_VSTD_Pool *pool) {
+  for (struct _VSTD_PoolBlock *slab = pool->slabs; slab;) {
+    struct _VSTD_PoolBlock *next = slab->next;
+    VSTD_FREE(slab);
+    slab = next;
+  }
+  *pool = vstd_pool_new(pool->block_size);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_pool_cache_new
+ *
+ * @description
+ *   Creates a new empty _VSTD_PoolCache in front of the pool.
+ *
+ * @param[in]
+ *   pool : _VSTD_Pool to cache.
+ *
+ * @return
+ *   New empty _VSTD_PoolCache.
+ *
+ * */
+VSTD_INLINE _VSTD_PoolCache vstd_pool_cache_new(_VSTD_Pool *pool) {
+  return (_VSTD_PoolCache){.pool = pool, .head = NULL, .count = 0};
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_pool_cache_flush_n
+ *
+ * @description
+ *   Gives count blocks of the cache back to its pool, taking the lock once.
+ *   This is a helper function and it's only meant to be used the vstd library
+ *   functions.
+ *
+ * @param[in]
+ *   cache : _VSTD_PoolCache to flush.
+ * @param[in]
+ *   count : Number of blocks to give back.
+ *
+ * */
+VSTD_STATIC void _vstd_pool_cache_flush_n(_VSTD_PoolCache *cache,
+                                          usize count) {
+  if (!count) {
+    return;
+  }
+
+  struct _VSTD_PoolBlock *first = cache->head;
+  struct _VSTD_PoolBlock *last = first;
+  for (usize i = 1; i < count; ++i) {
+    last = last->next;
+  }
+  cache->head = last->next;
+  cache->count -= count;
+
+  _VSTD_Pool *pool = cache->pool;
+  _vstd_pool_lock(pool);
+  last->next = pool->free_list;
+  pool->free_list = first;
+  pool->live -= count;
+  _vstd_pool_unlock(pool);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_pool_cache_alloc
+ *
+ * @description
+ *   Allocates a block from the cache. When the cache is empty, half of
+ *   VSTD_POOL_CACHE_CAP blocks are taken from the pool at once.
+ *
+ * @param[in]
+ *   cache : _VSTD_PoolCache to allocate from.
+ *
+ * @return
+ *   Pointer to the block, aligned to VSTD_POOL_ALIGNMENT.
+ *
+ * */
+VSTD_STATIC void *vstd_pool_cache_alloc(_VSTD_PoolCache *cache) {
+  if (!cache->head) {
+    _VSTD_Pool *pool = cache->pool;
+    usize count = VSTD_POOL_CACHE_CAP / 2 ? VSTD_POOL_CACHE_CAP / 2 : 1;
+
+    _vstd_pool_lock(pool);
+    for (usize i = 0; i < count; ++i) {
+      struct _VSTD_PoolBlock *block =
+          (struct _VSTD_PoolBlock *)_vstd_pool_take(pool);
+      block->next = cache->head;
+      cache->head = block;
+    }
+    pool->live += count;
+    if (pool->live > pool->peak) {
+      pool->peak = pool->live;
+    }
+    _vstd_pool_unlock(pool);
+
+    cache->count = count;
+  }
+
+  struct _VSTD_PoolBlock *block = cache->head;
+  cache->head = block->next;
+  cache->count--;
+
+  return block;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_pool_cache_free
+ *
+ * @description
+ *   Gives a block back to the cache. When the cache is full, half of its
+ *   blocks are given back to the pool at once.
+ *
+ * @param[in]
+ *   cache : _VSTD_PoolCache to give the block to.
+ * @param[in]
+ *   ptr : Pointer to the block, or NULL.
+ *
+ * */
+VSTD_STATIC void vstd_pool_cache_free(_VSTD_PoolCache *cache, void *ptr) {
+  if (!ptr) {
+    return;
+  }
+  if (cache->count >= VSTD_POOL_CACHE_CAP) {
+    _vstd_pool_cache_flush_n(cache, cache->count / 2 ? cache->count / 2 : 1);
+  }
+
+  struct _VSTD_PoolBlock *block = (struct _VSTD_PoolBlock *)ptr;
+  block->next = cache->head;
+  cache->head = block;
+  cache->count++;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_pool_cache_flush
+ *
+ * @description
+ *   Gives every block of the cache back to its pool.
+ *
+ * @param[in]
+ *   cache : _VSTD_PoolCache to flush.
+ *
+ * */
+VSTD_INLINE void vstd_pool_cache_flush(_VSTD_PoolCache *cache) {
+  _vstd_pool_cache_flush_n(cache, cache->count);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_pool_allocator_alloc
+ *
+ * @description
+ *   _VSTD_Allocator alloc entry of a pool, sizes larger than the block size
+ *   are allocated from the heap. This is a helper function and it's only meant
+ *   to be used the vstd library functions.
+ *
+ * */
+VSTD_STATIC void *_vstd_pool_allocator_alloc(void *ctx, usize size) {
+  _VSTD_Pool *pool = (_VSTD_Pool *)ctx;
+  if (size > pool->block_size) {
+    return VSTD_MALLOC(size);
+  }
+  return vstd_pool_alloc(pool);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_pool_allocator_free
+ *
+ * @description
+ *   _VSTD_Allocator free entry of a pool. This is a helper function and it's
+ *   only meant to be used the vstd library functions.
+ *
+ * */
+VSTD_STATIC void _vstd_pool_allocator_free(void *ctx, void *ptr, usize size) {
+  _VSTD_Pool *pool = (_VSTD_Pool *)ctx;
+  if (size > pool->block_size) {
+    VSTD_FREE(ptr);
+    return;
+  }
+  vstd_pool_free(pool, ptr);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_pool_allocator_realloc
+ *
+ * @description
+ *   _VSTD_Allocator realloc entry of a pool, blocks are only moved when the
+ *   new size crosses the block size. This is a helper function and it's only
+ *   meant to be used the vstd library functions.
+ *
+ * */
+VSTD_STATIC void *_vstd_pool_allocator_realloc(void *ctx, void *ptr,
+                                               usize old_size,
+                                               usize new_size) {
+  _VSTD_Pool *pool = (_VSTD_Pool *)ctx;
+  if (!ptr) {
+    return _vstd_pool_allocator_alloc(ctx, new_size);
+  }
+
+  bool old_pooled = old_size <= pool->block_size;
+  bool new_pooled = new_size <= pool->block_size;
+  if (old_pooled && new_pooled) {
+    return ptr;
+  }
+  if (!old_pooled && !new_pooled) {
+    return VSTD_REALLOC(ptr, new_size);
+  }
+
+  void *block = _vstd_pool_allocator_alloc(ctx, new_size);
+  memcpy(block, ptr, old_size < new_size ? old_size : new_size);
+  _vstd_pool_allocator_free(ctx, ptr, old_size);
+  return block;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_pool_allocator
+ *
+ * @description
+ *   Returns a _VSTD_Allocator backed by the pool, which can be used to bind
+ *   containers to it. Allocations larger than the block size fall back to the
+ *   heap, and the pool shouldn't be moved while containers bound to it are
+ *   alive.
+ *
+ * @param[in]
+ *   pool : _VSTD_Pool to allocate from.
+ *
+ * @return
+ *   Pointer to the pool's _VSTD_Allocator.
+ *
+ * */
+VSTD_INLINE const _VSTD_Allocator *vstd_pool_allocator(_VSTD_Pool *pool) {
+  pool->allocator = (_VSTD_Allocator){
+      .ctx = pool,
+      .alloc = _vstd_pool_allocator_alloc,
+      .realloc = _vstd_pool_allocator_realloc,
+      .free = _vstd_pool_allocator_free,
+  };
+  return &pool->allocator;
+}
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Map
+ *
+ * */
+
+/*****************************************************************************
+ *
+ * @type
+ *   _VSTD_Map
+ *
+ * @description
+ *   Map implementation, this type doesn't allocate any memory for itself, but
+ *   its underlying _VSTD_Vector's and its hash table allocate memory for their
+ *   pointers. Thus, it's safe to pass this type to functions as it is, as long
+ *   as said function doesn't alter any of the properties of _VSTD_Map or its
+ *   _VSTD_Vector's. Otherwise it should be passed as a reference or may result
+ *   in the lose of the underlying pointers.
+ *
+ *   Keys, values and their hashes are stored densely in insertion order inside
+ *   the _VSTD_Vector's, and an open-addressing hash table maps every key to its
+ *   index. Every slot of the table has a control byte, which is either empty,
+ *   deleted or holds the low 7 bits of the key's hash. Lookups scan the control
+ *   bytes a group at a time, and only call the condition function for the
+ *   slots whose control byte matches the key's hash.
+ *
+ * */
+struct _VSTD_Map {
+  struct _VSTD_Vector keys;
+  struct _VSTD_Vector vals;
+  struct _VSTD_Vector hashes;
+  void *func_ptr;
+  void *hash_ptr;
+  u8 *ctrl;
+  usize *slots;
+  usize cap;
+  usize growth;
+  usize slot;
+  iptr cache;
+  const _VSTD_Allocator *alloc;
+};
+
+#ifdef VSTD_MAP_STRIP_PREFIX
+#define Map(k, v) struct _VSTD_Map
+#else
+#define VSTD_Map(k, v) struct _VSTD_Map
+#endif
+
+#ifndef VSTD_MAP_INITIAL_CAP
+#define VSTD_MAP_INITIAL_CAP 16
+#endif
+
+#define VSTD_MAP_GROUP_WIDTH 16
+
+#define _VSTD_MAP_CTRL_EMPTY 0x80
+#define _VSTD_MAP_CTRL_DELETED 0xFE
+
+#define _VSTD_MAP_H1(hash) ((usize)((hash) >> 7))
+#define _VSTD_MAP_H2(hash) ((u8)((hash) & 0x7F))
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_new
+ *
+ * @description
+ *   Creates a new empty _VSTD_Map. The hash table is not allocated until the
+ *   first key is inserted.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   hash : Hash function that will be used to hash keys.
+ * @param[in]
+ *   condition : Condition function that will be used to compare keys.
+ *
+ * @return
+ *   New empty _VSTD_Map.
+ *
+ * */
+#define vstd_map_new(k, v, hash, condition)                                    \
+  (struct _VSTD_Map) {                                                         \
+    .keys = vstd_vector_new(k), .vals = vstd_vector_new(v),                    \
+    .hashes = vstd_vector_new(u64), .func_ptr = condition, .hash_ptr = hash,   \
+    .ctrl = NULL, .slots = NULL, .cap = 0, .growth = 0, .slot = 0,             \
+    .cache = -1, .alloc = NULL,                                                \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_with_allocator
+ *
+ * @description
+ *   Creates a new empty _VSTD_Map, whose _VSTD_Vectors and hash table are
+ *   allocated from the given allocator.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   hash : Hash function that will be used to hash keys.
+ * @param[in]
+ *   condition : Condition function that will be used to compare keys.
+ * @param[in]
+ *   allocator : Pointer to the _VSTD_Allocator to bind the map to.
+ *
+ * @return
+ *   New empty _VSTD_Map.
+ *
+ * */
+#define vstd_map_with_allocator(k, v, hash, condition, allocator)              \
+  (struct _VSTD_Map) {                                                         \
+    .keys = vstd_vector_with_allocator(k, VSTD_VECTOR_INITIAL_CAP, allocator), \
+    .vals = vstd_vector_with_allocator(v, VSTD_VECTOR_INITIAL_CAP, allocator), \
+    .hashes =                                                                  \
+        vstd_vector_with_allocator(u64, VSTD_VECTOR_INITIAL_CAP, allocator),   \
+    .func_ptr = condition, .hash_ptr = hash, .ctrl = NULL, .slots = NULL,      \
+    .cap = 0, .growth = 0, .slot = 0, .cache = -1, .alloc = allocator,         \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   _vstd_map_probe
+ *
+ * @description
+ *   Walks the probe sequence of the hash, looking for the key. The first empty
+ *   or deleted slot seen on the way is stored in insert, so a missing key can
+ *   be inserted without probing again. This is a helper macro and it's only
+ *   meant to be used the vstd library functions.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   map : Map to search for the key.
+ * @param[in]
+ *   key : Key to search for.
+ * @param[in]
+ *   hash : Hash of the key.
+ * @param[out]
+ *   index : iptr variable set to the key's index, or -1 if it's missing.
+ * @param[out]
+ *   insert : usize variable set to the insert slot, or _VSTD_MAP_NO_SLOT.
+ *
+ * */
+#define _VSTD_MAP_NO_SLOT (~(usize)0)
+
+#define _vstd_map_probe(k, map, key, hash, index, insert)                      \
+  do {                                                                         \
+    index = -1;                                                                \
+    insert = _VSTD_MAP_NO_SLOT;                                                \
+    if (map.cap) {                                                             \
+      usize _mask = map.cap / VSTD_MAP_GROUP_WIDTH - 1;                        \
+      usize _group = _VSTD_MAP_H1(hash) & _mask;                               \
+      for (usize _step = 1; _step <= _mask + 1; ++_step) {                     \
+        const u8 *_ctrl = map.ctrl + _group * VSTD_MAP_GROUP_WIDTH;            \
+        u32 _match = _vstd_map_group_match(_ctrl, _VSTD_MAP_H2(hash));         \
+        for (; _match; _match &= _match - 1) {                                 \
+          usize _slot =                                                        \
+              _group * VSTD_MAP_GROUP_WIDTH + (usize)__builtin_ctz(_match);    \
+          usize _index = map.slots[_slot];                                     \
+          if (((u64 *)map.hashes.ptr)[_index] == (hash) &&                     \
+              ((bool (*)(k, k))map.func_ptr)(((k *)map.keys.ptr)[_index],      \
+                                             key)) {                           \
+            index = (iptr)_index;                                              \
+            map.slot = _slot;                                                  \
+            break;                                                             \
+          }                                                                    \
+        }                                                                      \
+        if (index >= 0) {                                                      \
+          break;                                                               \
+        }                                                                      \
+        u32 _free = _vstd_map_group_match_free(_ctrl);                         \
+        if (insert == _VSTD_MAP_NO_SLOT && _free) {                            \
+          insert =                                                             \
+              _group * VSTD_MAP_GROUP_WIDTH + (usize)__builtin_ctz(_free);     \
+        }                                                                      \
+        if (_vstd_map_group_match(_ctrl, _VSTD_MAP_CTRL_EMPTY) != 0) {         \
+          break;                                                               \
+        }                                                                      \
+        _group = (_group + _step) & _mask;                                     \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_contains
+ *
+ * @description
+ *   Searches the supplied _VSTD_Map for the given key and stores the result in
+ *   a variable.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   map : Map to search for the key.
+ * @param[in]
+ *   key : Key to search for.
+ * @param[out]
+ *   result : Reference to the variable that the result will be stored in.
+ *
+ * */
+#define vstd_map_contains(k, v, map, key, result)                              \
+  do {                                                                         \
+    k _key = (key);                                                            \
+    u64 _hash = ((u64 (*)(k))map.hash_ptr)(_key);                              \
+    _vstd_map_contains_hashed(k, map, _key, _hash, result);                    \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   _vstd_map_contains_hashed
+ *
+ * @description
+ *   Same as vstd_map_contains, but takes the hash of the key, so a caller that
+ *   already hashed the key doesn't hash it again. The hash has to be the one
+ *   the hash function of the map returns for the key. This is a helper macro
+ *   and it's only meant to be used the vstd library functions.
+ *
+ * */
+#define _vstd_map_contains_hashed(k, map, key, hash, result)                   \
+  do {                                                                         \
+    k _contains_key = (key);                                                   \
+    u64 _contains_hash = (hash);                                               \
+    iptr _found;                                                               \
+    usize _insert;                                                             \
+    _vstd_map_probe(k, map, _contains_key, _contains_hash, _found, _insert);   \
+    (void)_insert;                                                             \
+    map.cache = _found;                                                        \
+    *(result) = _found >= 0;                                                   \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_set
+ *
+ * @description
+ *   Set's the value for the key to the supplied item. If the key is already
+ *   present in the given _VSTD_Map, item is just replaced with the new value,
+ *   if not both the key and the item are added to respective _VSTD_Vectors.
+ *   The key is only searched once, a missing key is inserted in the free slot
+ *   found by the search. This macro may resize the hash table of the
+ *   _VSTD_Map.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   map : Map to set the key and the value.
+ * @param[in]
+ *   key : Key.
+ * @param[in]
+ *   value : Value.
+ *
+ * */
+#define vstd_map_set(k, v, map, key, value)                                    \
+  do {                                                                         \
+    k _set_key = (key);                                                        \
+    u64 _set_hash = ((u64 (*)(k))map.hash_ptr)(_set_key);                      \
+    iptr _set_index;                                                           \
+    usize _set_slot;                                                           \
+    _vstd_map_probe(k, map, _set_key, _set_hash, _set_index, _set_slot);       \
+    map.cache = _set_index;                                                    \
+    if (_set_index < 0) {                                                      \
+      _vstd_map_insert_slot(&(map), _set_hash, map.keys.len, _set_slot);       \
+      vstd_vector_push(k, (&map.keys), _set_key);                              \
+      vstd_vector_push(v, (&map.vals), value);                                 \
+      vstd_vector_push(u64, (&map.hashes), _set_hash);                         \
+    } else {                                                                   \
+      vstd_vector_set(v, (&map.vals), _set_index, value);                      \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_get
+ *
+ * @description
+ *   Tries to retrieve a value from the given _VSTD_Map. If successful a pointer
+ *   to value is assigned to var, if not var is set to NULL.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   map : Map to get the value from.
+ * @param[in]
+ *   key : Key to access.
+ * @param[out]
+ *   var : Variable to store the value.
+ *
+ * */
+#define vstd_map_get(k, v, map, key, out)                                      \
+  do {                                                                         \
+    bool exists;                                                               \
+    vstd_map_contains(k, v, map, key, &exists);                                \
+    if (!exists) {                                                             \
+      out = NULL;                                                              \
+    } else {                                                                   \
+      out = &(vstd_vector_get(v, map.vals, map.cache));                        \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   _vstd_map_entry
+ *
+ * @description
+ *   Finds the key with a single probe and, if it's missing, runs init to push
+ *   its value and inserts the key in the free slot found by the probe. This is
+ *   a helper macro and it's only meant to be used the vstd library functions.
+ *
+ * */
+#define _vstd_map_entry(k, v, map, key, init, out, inserted)                   \
+  do {                                                                         \
+    k _hashed_key = (key);                                                     \
+    _vstd_map_entry_hashed(k, v, map, _hashed_key,                             \
+                           ((u64 (*)(k))map.hash_ptr)(_hashed_key), init, out, \
+                           inserted);                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   _vstd_map_entry_hashed
+ *
+ * @description
+ *   Same as _vstd_map_entry, but takes the hash of the key, which has to be the
+ *   one the hash function of the map returns for the key. This is a helper
+ *   macro and it's only meant to be used the vstd library functions.
+ *
+ * */
+#define _vstd_map_entry_hashed(k, v, map, key, hash, init, out, inserted)      \
+  do {                                                                         \
+    k _entry_key = (key);                                                      \
+    u64 _entry_hash = (hash);                                                  \
+    iptr _entry_index;                                                         \
+    usize _entry_slot;                                                         \
+    _vstd_map_probe(k, map, _entry_key, _entry_hash, _entry_index,             \
+                    _entry_slot);                                              \
+    *(inserted) = _entry_index < 0;                                            \
+    if (_entry_index < 0) {                                                    \
+      _entry_index = (iptr)map.keys.len;                                       \
+      _vstd_map_insert_slot(&(map), _entry_hash, map.keys.len, _entry_slot);   \
+      vstd_vector_push(k, (&map.keys), _entry_key);                            \
+      init;                                                                    \
+      vstd_vector_push(u64, (&map.hashes), _entry_hash);                       \
+    }                                                                          \
+    map.cache = _entry_index;                                                  \
+    out = &(vstd_vector_get(v, map.vals, _entry_index));                       \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   _vstd_map_push_zero
+ *
+ * @description
+ *   Pushes a zeroed value to the values of the map. This is a helper macro and
+ *   it's only meant to be used the vstd library functions.
+ *
+ * */
+#define _vstd_map_push_zero(v, map)                                            \
+  do {                                                                         \
+    v _zero;                                                                   \
+    memset(&_zero, 0, sizeof(_zero));                                          \
+    vstd_vector_push(v, (&map.vals), _zero);                                   \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_entry
+ *
+ * @description
+ *   Returns a pointer to the value of the key, inserting the key with a zeroed
+ *   value if it's missing, so the value can be updated in place. The key is
+ *   only hashed and searched once. The key is only stored when it's inserted,
+ *   otherwise the caller still owns it. The pointer is valid until the next
+ *   insertion or removal.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   map : Map to modify.
+ * @param[in]
+ *   key : Key to access.
+ * @param[out]
+ *   out : Variable to store the pointer to the value.
+ * @param[out]
+ *   inserted : Pointer to a bool, set to true if the key was inserted.
+ *
+ * */
+#define vstd_map_entry(k, v, map, key, out, inserted)                          \
+  _vstd_map_entry(k, v, map, key, _vstd_map_push_zero(v, map), out, inserted)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_get_or_insert
+ *
+ * @description
+ *   Returns a pointer to the value of the key, inserting the key with the
+ *   supplied value if it's missing. The value is only evaluated when the key
+ *   is inserted. The key is only hashed and searched once, and the pointer is
+ *   valid until the next insertion or removal.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   map : Map to modify.
+ * @param[in]
+ *   key : Key to access.
+ * @param[in]
+ *   value : Value of the key if it's missing.
+ * @param[out]
+ *   out : Variable to store the pointer to the value.
+ *
+ * */
+#define vstd_map_get_or_insert(k, v, map, key, value, out)                     \
+  do {                                                                         \
+    bool _get_inserted;                                                        \
+    _vstd_map_entry(k, v, map, key, vstd_vector_push(v, (&map.vals), value),   \
+                    out, &_get_inserted);                                      \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_insert_or_assign
+ *
+ * @description
+ *   Same as vstd_map_set, but also reports if the key was inserted. When the
+ *   key is already present the caller still owns the supplied key.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   map : Map to modify.
+ * @param[in]
+ *   key : Key to set.
+ * @param[in]
+ *   value : Value to set.
+ * @param[out]
+ *   inserted : Pointer to a bool, set to true if the key was inserted.
+ *
+ * */
+#define vstd_map_insert_or_assign(k, v, map, key, value, inserted)             \
+  do {                                                                         \
+    v *_assign_ptr;                                                            \
+    _vstd_map_entry(k, v, map, key, vstd_vector_push(v, (&map.vals), value),   \
+                    _assign_ptr, inserted);                                    \
+    if (!*(inserted)) {                                                        \
+      *_assign_ptr = (value);                                                  \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_remove
+ *
+ * @description
+ *   Tries to remove the key and its associated value from the given _VSTD_Map
+ *   in O(1), same as vstd_map_swap_remove. The last key and value are moved
+ *   into the place of the removed ones, so the insertion order is not
+ *   preserved, use vstd_map_ordered_remove if it has to be.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   map : Map to remove the key from.
+ * @param[in]
+ *   key : Key to remove.
+ *
+ * */
+#define vstd_map_remove(k, v, map, key) vstd_map_swap_remove(k, v, map, key)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_ordered_remove
+ *
+ * @description
+ *   Tries to remove the key and its associated value from the given _VSTD_Map,
+ *   keeping the insertion order of the remaining keys. If the removed key is
+ *   not the last one, remaining items are shifted to left and every index in
+ *   the hash table is updated, which costs O(cap + n). Removing many keys this
+ *   way is quadratic, prefer vstd_map_remove when the order doesn't matter.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   map : Map to remove the key from.
+ * @param[in]
+ *   key : Key to remove.
+ *
+ * */
+#define vstd_map_ordered_remove(k, v, map, key)                                \
+  do {                                                                         \
+    bool exists;                                                               \
+    vstd_map_contains(k, v, map, key, &exists);                                \
+    if (exists) {                                                              \
+      _vstd_map_erase_slot(&(map), map.slot);                                  \
+      _vstd_map_shift_indices(&(map), (usize)map.cache);                       \
+      vstd_vector_remove(k, (&map.keys), map.cache);                           \
+      vstd_vector_remove(v, (&map.vals), map.cache);                           \
+      vstd_vector_remove(u64, (&map.hashes), map.cache);                       \
+      map.cache = -1;                                                          \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_swap_remove
+ *
+ * @description
+ *   Tries to remove the key and its associated value from the given _VSTD_Map
+ *   in O(1). The last key and value are moved into the place of the removed
+ *   ones, so the insertion order is not preserved.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   map : Map to remove the key from.
+ * @param[in]
+ *   key : Key to remove.
+ *
+ * */
+#define vstd_map_swap_remove(k, v, map, key)                                   \
+  do {                                                                         \
+    bool exists;                                                               \
+    vstd_map_contains(k, v, map, key, &exists);                                \
+    if (exists) {                                                              \
+      _vstd_map_erase_slot(&(map), map.slot);                                  \
+      _vstd_map_move_index(&(map), map.keys.len - 1, (usize)map.cache);        \
+      vstd_vector_swap_remove(k, (&map.keys), map.cache);                      \
+      vstd_vector_swap_remove(v, (&map.vals), map.cache);                      \
+      vstd_vector_swap_remove(u64, (&map.hashes), map.cache);                  \
+      map.cache = -1;                                                          \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_iter
+ *
+ * @description
+ *   Helper function to easily iterate trough the all the keys and values stored
+ *   in a _VSTD_Map. In every iteration it is possible to access the current key
+ *   and value from _$iter and current index from _$i.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   map : _VSTD_Map to iterate.
+ * @param[in]
+ *   ... : A single function or a block of code to execute every iteration.
+ *
+ * */
+#define vstd_map_iter(k, v, map, ...)                                          \
+  do {                                                                         \
+    struct _VSTDMapPair {                                                      \
+      k *key;                                                                  \
+      v *val;                                                                  \
+    };                                                                         \
+    for (usize _$i = 0; _$i < map.keys.len; ++_$i) {                           \
+      struct _VSTDMapPair _$iter = (struct _VSTDMapPair){                      \
+          .key = &(vstd_vector_get(k, map.keys, _$i)),                         \
+          .val = &(vstd_vector_get(v, map.vals, _$i)),                         \
+      };                                                                       \
+      __VA_ARGS__;                                                             \
+      (void)(_$i);                                                             \
+      (void)(_$iter);                                                          \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_clear
+ *
+ * @description
+ *   Set's given _VSTD_Map's underlying _VSTD_Vector's lengths to 0, basically
+ *   soft resetting them, and marks every slot of the hash table as empty. This
+ *   doesn't actually modify or free the underlying pointers.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   map : _VSTD_Map to clear.
+ *
+ * */
+#define vstd_map_clear(k, v, map)                                              \
+  do {                                                                         \
+    vstd_vector_clear(k, (&map.keys));                                         \
+    vstd_vector_clear(v, (&map.vals));                                         \
+    vstd_vector_clear(u64, (&map.hashes));                                     \
+    _vstd_map_reset(&(map));                                                   \
+    map.cache = -1;                                                            \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_free
+ *
+ * @description
+ *   Frees all the memory allocated for the _VSTD_Map by freeing its underlying
+ *   _VSTD_Vectors and its hash table.
+ *
+ * @param[in]
+ *   k : Type of the keys stored in _VSTD_Map.
+ * @param[in]
+ *   v : Type of the values stored in _VSTD_Map.
+ * @param[in]
+ *   map : _VSTD_Map to free.
+ *
+ * */
+#define vstd_map_free(k, v, map)                                               \
+  do {                                                                         \
+    vstd_vector_free(k, (&map.keys));                                          \
+    vstd_vector_free(v, (&map.vals));                                          \
+    vstd_vector_free(u64, (&map.hashes));                                      \
+    if (map.cap) {                                                             \
+      vstd_free(map.alloc, map.ctrl, sizeof(u8) * map.cap);                    \
+      vstd_free(map.alloc, map.slots, sizeof(usize) * map.cap);                \
+    }                                                                          \
+    map.ctrl = NULL;                                                           \
+    map.slots = NULL;                                                          \
+    map.cap = 0;                                                               \
+    map.growth = 0;                                                            \
+    map.cache = -1;                                                            \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Map hash table helpers
+ *
+ * @description
+ *   Type independent functions that maintain the hash table of a _VSTD_Map.
+ *   These are helper functions and they're only meant to be used by the vstd
+ *   library macros.
+ *
+ * */
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_map_group_match
+ *
+ * @description
+ *   Compares every control byte in the group starting at ctrl with the given
+ *   byte, and returns a bit mask of the matching slots.
+ *
+ * */
+VSTD_INLINE u32 _vstd_map_group_match(const u8 *ctrl, u8 byte) {
+#ifdef __SSE2__
+  __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+  __m128i match = _mm_cmpeq_epi8(group, _mm_set1_epi8((char)byte));
+  return (u32)_mm_movemask_epi8(match);
+#else
+  u32 mask = 0;
+  for (usize i = 0; i < VSTD_MAP_GROUP_WIDTH; ++i) {
+    mask |= (u32)(ctrl[i] == byte) << i;
+  }
+  return mask;
+#endif
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_map_group_match_free
+ *
+ * @description
+ *   Returns a bit mask of the empty or deleted slots in the group starting at
+ *   ctrl.
+ *
+ * */
+VSTD_INLINE u32 _vstd_map_group_match_free(const u8 *ctrl) {
+#ifdef __SSE2__
+  __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+  return (u32)_mm_movemask_epi8(group);
+#else
+  u32 mask = 0;
+  for (usize i = 0; i < VSTD_MAP_GROUP_WIDTH; ++i) {
+    mask |= (u32)(ctrl[i] >> 7) << i;
+  }
+  return mask;
+#endif
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_map_find_insert_slot
+ *
+ * @description
+ *   Returns the first empty or deleted slot in the probe sequence of the hash.
+ *   The hash table must be allocated and have at least one free slot.
+ *
+ * */
+VSTD_STATIC usize _vstd_map_find_insert_slot(const struct _VSTD_Map *map,
+                                             u64 hash) {
+  usize mask = map->cap / VSTD_MAP_GROUP_WIDTH - 1;
+  usize group = _VSTD_MAP_H1(hash) & mask;
+
+  for (usize step = 1;; ++step) {
+    u32 mask_free =
+        _vstd_map_group_match_free(map->ctrl + group * VSTD_MAP_GROUP_WIDTH);
+    if (mask_free) {
+      return group * VSTD_MAP_GROUP_WIDTH + (usize)__builtin_ctz(mask_free);
+    }
+    group = (group + step) & mask;
+  }
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_map_rehash
+ *
+ * @description
+ *   Reallocates the hash table with the given capacity, and reinserts every
+ *   key using the hashes stored in the _VSTD_Map. Capacity must be a power of
+ *   two, and at least VSTD_MAP_GROUP_WIDTH.
+ *
+ * */
+VSTD_STATIC void _vstd_map_rehash(struct _VSTD_Map *map, usize cap) {
+  if (map->cap) {
+    vstd_free(map->alloc, map->ctrl, sizeof(u8) * map->cap);
+    vstd_free(map->alloc, map->slots, sizeof(usize) * map->cap);
+  }
+
+  map->ctrl = (u8 *)vstd_alloc(map->alloc, sizeof(u8) * cap);
+  map->slots = (usize *)vstd_alloc(map->alloc, sizeof(usize) * cap);
+  map->cap = cap;
+
+  memset(map->ctrl, _VSTD_MAP_CTRL_EMPTY, sizeof(u8) * cap);
+  for (usize i = 0; i < map->hashes.len; ++i) {
+    u64 hash = ((u64 *)map->hashes.ptr)[i];
+    usize slot = _vstd_map_find_insert_slot(map, hash);
+
+    map->ctrl[slot] = _VSTD_MAP_H2(hash);
+    map->slots[slot] = i;
+  }
+
+  map->growth = cap - cap / 8 - map->hashes.len;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_map_insert_slot
+ *
+ * @description
+ *   Inserts the index of a new key with the given hash into the hash table, at
+ *   the free slot found by _vstd_map_probe. If the table is out of free slots
+ *   it's either cleaned of deleted slots, or its capacity is doubled to keep
+ *   the load factor below 7/8, and the slot is searched again.
+ *
+ * @param[in]
+ *   map : Map to modify.
+ * @param[in]
+ *   hash : Hash of the new key.
+ * @param[in]
+ *   index : Index of the new key.
+ * @param[in]
+ *   slot : Free slot on the probe sequence, or _VSTD_MAP_NO_SLOT.
+ *
+ * */
+VSTD_STATIC void _vstd_map_insert_slot(struct _VSTD_Map *map, u64 hash,
+                                       usize index, usize slot) {
+  if (map->growth == 0) {
+    usize cap = map->cap ? map->cap : VSTD_MAP_INITIAL_CAP;
+    if (map->hashes.len + 1 > cap / 2) {
+      cap *= 2;
+    }
+    _vstd_map_rehash(map, cap);
+    slot = _VSTD_MAP_NO_SLOT;
+  }
+
+  if (slot == _VSTD_MAP_NO_SLOT) {
+    slot = _vstd_map_find_insert_slot(map, hash);
+  }
+  if (map->ctrl[slot] == _VSTD_MAP_CTRL_EMPTY) {
+    map->growth--;
+  }
+
+  map->ctrl[slot] = _VSTD_MAP_H2(hash);
+  map->slots[slot] = index;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_map_erase_slot
+ *
+ * @description
+ *   Frees the given slot of the hash table. If the slot's group already has an
+ *   empty slot, probes never continue past it, so the slot can be marked as
+ *   empty. Otherwise it's marked as deleted.
+ *
+ * */
+VSTD_STATIC void _vstd_map_erase_slot(struct _VSTD_Map *map, usize slot) {
+  usize group = slot / VSTD_MAP_GROUP_WIDTH * VSTD_MAP_GROUP_WIDTH;
+
+  if (_vstd_map_group_match(map->ctrl + group, _VSTD_MAP_CTRL_EMPTY)) {
+    map->ctrl[slot] = _VSTD_MAP_CTRL_EMPTY;
+    map->growth++;
+  } else {
+    map->ctrl[slot] = _VSTD_MAP_CTRL_DELETED;
+  }
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_map_shift_indices
+ *
+ * @description
+ *   Decrements every index stored in the hash table that is greater than the
+ *   removed index, to keep the table in sync with the shifted _VSTD_Vectors.
+ *
+ * */
+VSTD_STATIC void _vstd_map_shift_indices(struct _VSTD_Map *map, usize index) {
+  if (index + 1 == map->keys.len) {
+    return;
+  }
+
+  for (usize i = 0; i < map->cap; ++i) {
+    if (!(map->ctrl[i] & 0x80) && map->slots[i] > index) {
+      map->slots[i]--;
+    }
+  }
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_map_move_index
+ *
+ * @description
+ *   Finds the slot pointing to the from index by probing with its stored hash,
+ *   and points it to the to index instead. Used when the entry at from is
+ *   moved inside of the _VSTD_Vectors.
+ *
+ * */
+VSTD_STATIC void _vstd_map_move_index(struct _VSTD_Map *map, usize from,
+                                      usize to) {
+  if (from == to) {
+    return;
+  }
+
+  u64 hash = ((u64 *)map->hashes.ptr)[from];
+  usize mask = map->cap / VSTD_MAP_GROUP_WIDTH - 1;
+  usize group = _VSTD_MAP_H1(hash) & mask;
+
+  for (usize step = 1; step <= mask + 1; ++step) {
+    const u8 *ctrl = map->ctrl + group * VSTD_MAP_GROUP_WIDTH;
+    u32 match = _vstd_map_group_match(ctrl, _VSTD_MAP_H2(hash));
+    for (; match; match &= match - 1) {
+      usize slot = group * VSTD_MAP_GROUP_WIDTH + (usize)__builtin_ctz(match);
+      if (map->slots[slot] == from) {
+        map->slots[slot] = to;
+        return;
+      }
+    }
+    group = (group + step) & mask;
+  }
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_map_reset
+ *
+ * @description
+ *   Marks every slot of the hash table as empty without freeing it.
+ *
+ * */
+VSTD_STATIC void _vstd_map_reset(struct _VSTD_Map *map) {
+  if (!map->cap) {
+    return;
+  }
+
+  memset(map->ctrl, _VSTD_MAP_CTRL_EMPTY, sizeof(u8) * map->cap);
+  map->growth = map->cap - map->cap / 8;
+}
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Map Predefined Condition Functions
+ *
+ * @description
+ *   Predefined functions that can be supplied to a _VSTD_Map as a compare
+ *   function for its keys.
+ *
+ * */
+
+#ifndef VSTD_MAP_NO_PREDEFINED_CONDITIONS
+VSTD_STATIC bool vstd_map_condition_isize(isize a, isize b) { return a == b; }
+
+VSTD_STATIC bool vstd_map_condition_usize(usize a, usize b) { return a == b; }
+
+VSTD_STATIC bool vstd_map_condition_string(const _VSTD_String a,
+                                           const _VSTD_String b) {
+  usize len = vstd_string_len(&a);
+  return len == vstd_string_len(&b) &&
+         memcmp(vstd_string_ptr(&a), vstd_string_ptr(&b), len) == 0;
+}
+
+VSTD_STATIC bool vstd_map_condition_hstring(const _VSTD_HString a,
+                                            const _VSTD_HString b) {
+  return vstd_hstring_equal(&a, &b);
+}
+
+VSTD_STATIC bool vstd_map_condition_strview(const _VSTD_StrView a,
+                                            const _VSTD_StrView b) {
+  return a.len == b.len && memcmp(a.ptr, b.ptr, a.len) == 0;
+}
+
+VSTD_STATIC bool vstd_map_condition_void(const void *a, const void *b) {
+  return a == b;
+}
+#endif
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Map Predefined Hash Functions
+ *
+ * @description
+ *   Predefined functions that can be supplied to a _VSTD_Map as a hash function
+ *   for its keys, each one matches the predefined condition with same suffix.
+ *
+ * */
+
+#ifndef VSTD_MAP_NO_PREDEFINED_HASHES
+VSTD_STATIC u64 vstd_map_hash_isize(isize a) {
+  return vstd_hash_u64((u64)a, _vstd_hash_seed);
+}
+
+VSTD_STATIC u64 vstd_map_hash_usize(usize a) {
+  return vstd_hash_u64((u64)a, _vstd_hash_seed);
+}
+
+VSTD_STATIC u64 vstd_map_hash_string(const _VSTD_String a) {
+  return vstd_hash_bytes(vstd_string_ptr(&a), vstd_string_len(&a),
+                         _vstd_hash_seed);
+}
+
+VSTD_STATIC u64 vstd_map_hash_hstring(const _VSTD_HString a) {
+  return a.hash;
+}
+
+VSTD_STATIC u64 vstd_map_hash_strview(const _VSTD_StrView a) {
+  return vstd_hash_bytes(a.ptr, a.len, _vstd_hash_seed);
+}
+
+VSTD_STATIC u64 vstd_map_hash_void(const void *a) {
+  return vstd_hash_u64((u64)(uptr)a, _vstd_hash_seed);
+}
+#endif
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD FlatMap
+ *
+ * @description
+ *   Ordered map stored as two sorted _VSTD_Vectors of keys and values. Lookups
+ *   are binary searches over the densely packed keys, and iteration is a scan
+ *   of two arrays, which makes it the fastest ordered map for read-mostly
+ *   data. Inserting a single key shifts every greater key, so batches should
+ *   be added with name_insert_n, which sorts them and merges them in a single
+ *   pass.
+ *
+ * */
+
+/*****************************************************************************
+ *
+ * @macro
+ *   VSTD_FLAT_MAP_DEFINE
+ *
+ * @description
+ *   Defines a sorted flat map struct with the given name, from K keys to V
+ *   values ordered by less, which is called the same way as the comparison of
+ *   VSTD_SORT_DEFINE. The searches and the sorts are defined with
+ *   VSTD_SORT_DEFINE, with the name_key and the name_entry prefixes. The
+ *   following functions are defined:
+ *
+ *     name name_new(void);
+ *     name name_with_allocator(const _VSTD_Allocator *allocator);
+ *     usize name_len(const name *map);
+ *     usize name_lower_bound(const name *map, K key);
+ *     usize name_upper_bound(const name *map, K key);
+ *     usize name_range(const name *map, K lo, K hi, usize *end);
+ *     name_pair name_at(const name *map, usize index);
+ *     V *name_get(const name *map, K key);
+ *     bool name_set(name *map, K key, V val);
+ *     void name_insert_n(name *map, const K *keys, const V *vals, usize count);
+ *     bool name_remove(name *map, K key, V *out);
+ *     void name_clear(name *map);
+ *     void name_free(name *map);
+ *
+ *   name_get returns NULL if the key is missing, name_set and name_remove
+ *   return true if the key was inserted or removed. name_insert_n inserts a
+ *   batch of unsorted pairs, when a key is repeated the last pair wins. Pairs
+ *   hold pointers to a key and its value, which are valid until the map is
+ *   modified. Flat maps can be iterated with vstd_flat_map_iter and
+ *   vstd_flat_map_range.
+ *
+ * @param[in]
+ *   name : Name of the struct, also used as the prefix of the functions.
+ * @param[in]
+ *   K : Type of the keys.
+ * @param[in]
+ *   V : Type of the values.
+ * @param[in]
+ *   less : Comparison of the keys.
+ *
+ * */
+#define VSTD_FLAT_MAP_DEFINE(name, K, V, less)                                 \
+  VSTD_SORT_DEFINE(name##_key, K, less)                                        \
+                                                                               \
+  typedef struct name {                                                        \
+    struct _VSTD_Vector keys;                                                  \
+    struct _VSTD_Vector vals;                                                  \
+  } name;                                                                      \
+                                                                               \
+  typedef struct name##_pair {                                                 \
+    K *key;                                                                    \
+    V *val;                                                                    \
+  } name##_pair;                                                               \
+                                                                               \
+  typedef struct name##_entry {                                                \
+    K key;                                                                     \
+    V val;                                                                     \
+    usize order;                                                               \
+  } name##_entry;                                                              \
+                                                                               \
+  VSTD_INLINE bool name##_entry_less(name##_entry a, name##_entry b) {         \
+    return less(a.key, b.key) || (!less(b.key, a.key) && a.order < b.order);   \
+  }                                                                            \
+                                                                               \
+  VSTD_SORT_DEFINE(name##_entry, name##_entry, name##_entry_less)              \
+                                                                               \
+  VSTD_INLINE name name##_with_allocator(const _VSTD_Allocator *allocator) {   \
+    return (name){                                                             \
+        .keys = vstd_vector_with_allocator(K, VSTD_VECTOR_INITIAL_CAP,         \
+                                           allocator),                         \
+        .vals = vstd_vector_with_allocator(V, VSTD_VECTOR_INITIAL_CAP,         \
+                                           allocator),                         \
+    };                                                                         \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name name##_new(void) { return name##_with_allocator(NULL); }    \
+                                                                               \
+  VSTD_INLINE usize name##_len(const name *map) { return map->keys.len; }      \
+                                                                               \
+  VSTD_INLINE usize name##_lower_bound(const name *map, K key) {               \
+    return name##_key_lower_bound((const K *)map->keys.ptr, map->keys.len,     \
+                                  key);                                        \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE usize name##_upper_bound(const name *map, K key) {               \
+    return name##_key_upper_bound((const K *)map->keys.ptr, map->keys.len,     \
+                                  key);                                        \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE usize name##_range(const name *map, K lo, K hi, usize *end) {    \
+    usize begin = name##_lower_bound(map, lo);                                 \
+    *end = less(lo, hi) ? name##_lower_bound(map, hi) : begin;                 \
+    return begin;                                                              \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name##_pair name##_at(const name *map, usize index) {            \
+    return (name##_pair){                                                      \
+        .key = (K *)map->keys.ptr + index,                                     \
+        .val = (V *)map->vals.ptr + index,                                     \
+    };                                                                         \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE V *name##_get(const name *map, K key) {                          \
+    usize index;                                                               \
+    if (!name##_key_binary_search((const K *)map->keys.ptr, map->keys.len,     \
+                                  key, &index)) {                              \
+      return NULL;                                                             \
+    }                                                                          \
+    return (V *)map->vals.ptr + index;                                         \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC bool name##_set(name *map, K key, V val) {                       \
+    usize len = map->keys.len;                                                 \
+    K *keys = (K *)map->keys.ptr;                                              \
+    usize index = len;                                                         \
+    if (len && !less(keys[len - 1], key)) {                                    \
+      index = name##_key_lower_bound(keys, len, key);                          \
+      if (!less(key, keys[index])) {                                           \
+        ((V *)map->vals.ptr)[index] = val;                                     \
+        return false;                                                          \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    _vstd_vector_grow(&map->keys, sizeof(K), len + 1);                         \
+    _vstd_vector_grow(&map->vals, sizeof(V), len + 1);                         \
+    keys = (K *)map->keys.ptr;                                                 \
+    V *vals = (V *)map->vals.ptr;                                              \
+    memmove(keys + index + 1, keys + index, sizeof(K) * (len - index));        \
+    memmove(vals + index + 1, vals + index, sizeof(V) * (len - index));        \
+    keys[index] = key;                                                         \
+    vals[index] = val;                                                         \
+    map->keys.len++;                                                           \
+    map->vals.len++;                                                           \
+    return true;                                                               \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_insert_n(name *map, const K *keys, const V *vals,    \
+                                   usize count) {                              \
+    if (!count) {                                                              \
+      return;                                                                  \
+    }                                                                          \
+                                                                               \
+    name##_entry *batch =                                                      \
+        (name##_entry *)VSTD_MALLOC(sizeof(name##_entry) * count);             \
+    for (usize i = 0; i < count; ++i) {                                        \
+      batch[i] = (name##_entry){.key = keys[i], .val = vals[i], .order = i};   \
+    }                                                                          \
+    name##_entry_sort(batch, count);                                           \
+    usize unique = 0;                                                          \
+    for (usize i = 0; i < count; ++i) {                                        \
+      if (i + 1 == count || less(batch[i].key, batch[i + 1].key)) {            \
+        batch[unique++] = batch[i];                                            \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    usize len = map->keys.len;                                                 \
+    usize cap = len + unique;                                                  \
+    struct _VSTD_Vector out_keys =                                             \
+        vstd_vector_with_allocator(K, cap, map->keys.alloc);                   \
+    struct _VSTD_Vector out_vals =                                             \
+        vstd_vector_with_allocator(V, cap, map->vals.alloc);                   \
+    const K *old_keys = (const K *)map->keys.ptr;                              \
+    const V *old_vals = (const V *)map->vals.ptr;                              \
+    K *new_keys = (K *)out_keys.ptr;                                           \
+    V *new_vals = (V *)out_vals.ptr;                                           \
+    usize i = 0, j = 0, n = 0;                                                 \
+    while (i < len && j < unique) {                                            \
+      if (less(old_keys[i], batch[j].key)) {                                   \
+        new_keys[n] = old_keys[i];                                             \
+        new_vals[n++] = old_vals[i++];                                         \
+      } else {                                                                 \
+        if (!less(batch[j].key, old_keys[i])) {                                \
+          i++;                                                                 \
+        }                                                                      \
+        new_keys[n] = batch[j].key;                                            \
+        new_vals[n++] = batch[j++].val;                                        \
+      }                                                                        \
+    }                                                                          \
+    memcpy(new_keys + n, old_keys + i, sizeof(K) * (len - i));                 \
+    memcpy(new_vals + n, old_vals + i, sizeof(V) * (len - i));                 \
+    n += len - i;                                                              \
+    for (; j < unique; ++j, ++n) {                                             \
+      new_keys[n] = batch[j].key;                                              \
+      new_vals[n] = batch[j].val;                                              \
+    }                                                                          \
+    VSTD_FREE(batch);                                                          \
+                                                                               \
+    vstd_vector_free(K, (&map->keys));                                         \
+    vstd_vector_free(V, (&map->vals));                                         \
+    out_keys.len = n;                                                          \
+    out_vals.len = n;                                                          \
+    map->keys = out_keys;                                                      \
+    map->vals = out_vals;                                                      \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC bool name##_remove(name *map, K key, V *out) {                   \
+    usize index;                                                               \
+    if (!name##_key_binary_search((const K *)map->keys.ptr, map->keys.len,     \
+                                  key, &index)) {                              \
+      return false;                                                            \
+    }                                                                          \
+                                                                               \
+    K *keys = (K *)map->keys.ptr;                                              \
+    V *vals = (V *)map->vals.ptr;                                              \
+    if (out) {                                                                 \
+      *out = vals[index];                                                      \
+    }                                                                          \
+    usize rest = map->keys.len - index - 1;                                    \
+    memmove(keys + index, keys + index + 1, sizeof(K) * rest);                 \
+    memmove(vals + index, vals + index + 1, sizeof(V) * rest);                 \
+    map->keys.len--;                                                           \
+    map->vals.len--;                                                           \
+    return true;                                                               \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_clear(name *map) {                                   \
+    map->keys.len = 0;                                                         \
+    map->vals.len = 0;                                                         \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_free(name *map) {                                    \
+    vstd_vector_free(K, (&map->keys));                                         \
+    vstd_vector_free(V, (&map->vals));                                         \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_flat_map_iter
+ *
+ * @description
+ *   Iterates trough the keys and values of a flat map in ascending order of
+ *   the keys. In every iteration it is possible to access the current key and
+ *   value from _$iter and current index from _$i.
+ *
+ * @param[in]
+ *   name : Name passed to VSTD_FLAT_MAP_DEFINE.
+ * @param[in]
+ *   map : Flat map to iterate.
+ * @param[in]
+ *   ... : A single function or a block of code to execute every iteration.
+ *
+ * */
+#define vstd_flat_map_iter(name, map, ...)                                     \
+  do {                                                                         \
+    for (usize _$i = 0; _$i < (map).keys.len; ++_$i) {                         \
+      name##_pair _$iter = name##_at(&(map), _$i);                             \
+      __VA_ARGS__;                                                             \
+      (void)(_$i);                                                             \
+      (void)(_$iter);                                                          \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_flat_map_range
+ *
+ * @description
+ *   Same as vstd_flat_map_iter, but only iterates the keys which are not less
+ *   than lo and less than hi. _$i is the index of the current key in the map.
+ *
+ * @param[in]
+ *   name : Name passed to VSTD_FLAT_MAP_DEFINE.
+ * @param[in]
+ *   map : Flat map to iterate.
+ * @param[in]
+ *   lo : Lower bound of the keys, inclusive.
+ * @param[in]
+ *   hi : Upper bound of the keys, exclusive.
+ * @param[in]
+ *   ... : A single function or a block of code to execute every iteration.
+ *
+ * */
+#define vstd_flat_map_range(name, map, lo, hi, ...)                            \
+  do {                                                                         \
+    usize _end;                                                                \
+    for (usize _$i = name##_range(&(map), lo, hi, &_end); _$i < _end; ++_$i) { \
+      name##_pair _$iter = name##_at(&(map), _$i);                             \
+      __VA_ARGS__;                                                             \
+      (void)(_$i);                                                             \
+      (void)(_$iter);                                                          \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD BTree
+ *
+ * @description
+ *   Ordered map stored as a B+tree with wide nodes. Every node holds up to
+ *   VSTD_BTREE_NODE_CAP sorted keys in a single array, so a lookup touches a
+ *   few cache lines per level and the tree stays shallow. Values are only
+ *   stored in the leaves, which are linked in ascending order, so iterating
+ *   and range scans never climb back up the tree. Inserting and removing a
+ *   key only moves the items of a single node, and splits, borrows or merges
+ *   nodes along the path of the key to keep them at least half full.
+ *
+ * */
+
+#ifndef VSTD_BTREE_NODE_CAP
+#define VSTD_BTREE_NODE_CAP 32
+#endif
+
+#define _VSTD_BTREE_MIN_LEAF (VSTD_BTREE_NODE_CAP / 2)
+#define _VSTD_BTREE_MIN_INNER (VSTD_BTREE_NODE_CAP / 2 - 1)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   VSTD_BTREE_DEFINE
+ *
+ * @description
+ *   Defines a B+tree struct with the given name, from K keys to V values
+ *   ordered by less, which is called the same way as the comparison of
+ *   VSTD_SORT_DEFINE. Nodes are searched with the functions defined by
+ *   VSTD_SORT_DEFINE with the name_key prefix. VSTD_BTREE_NODE_CAP has to be
+ *   at least 4. The following functions are defined:
+ *
+ *     name name_new(void);
+ *     name name_with_allocator(const _VSTD_Allocator *allocator);
+ *     usize name_len(const name *tree);
+ *     V *name_get(const name *tree, K key);
+ *     bool name_set(name *tree, K key, V val);
+ *     bool name_remove(name *tree, K key, V *out);
+ *     name_cursor name_begin(const name *tree);
+ *     name_cursor name_lower_bound(const name *tree, K key);
+ *     name_cursor name_range(const name *tree, K lo, K hi, name_cursor *end);
+ *     void name_cursor_next(name_cursor *cursor);
+ *     name_pair name_cursor_get(name_cursor cursor);
+ *     void name_clear(name *tree);
+ *     void name_free(name *tree);
+ *
+ *   name_get returns NULL if the key is missing, name_set and name_remove
+ *   return true if the key was inserted or removed. A cursor points to an
+ *   item of a leaf, its leaf is NULL past the last item. Cursors, pairs and
+ *   value pointers are valid until the tree is modified. Trees can be
+ *   iterated with vstd_btree_iter and vstd_btree_range.
+ *
+ * @param[in]
+ *   name : Name of the struct, also used as the prefix of the functions.
+ * @param[in]
+ *   K : Type of the keys.
+ * @param[in]
+ *   V : Type of the values.
+ * @param[in]
+ *   less : Comparison of the keys.
+ *
+ * */
+#define VSTD_BTREE_DEFINE(name, K, V, less)                                    \
+  VSTD_SORT_DEFINE(name##_key, K, less)                                        \
+                                                                               \
+  typedef struct name##_leaf {                                                 \
+    usize len;                                                                 \
+    struct name##_leaf *next;                                                  \
+    K keys[VSTD_BTREE_NODE_CAP];                                               \
+    V vals[VSTD_BTREE_NODE_CAP];                                               \
+  } name##_leaf;                                                               \
+                                                                               \
+  typedef struct name##_inner {                                                \
+    usize len;                                                                 \
+    K keys[VSTD_BTREE_NODE_CAP];                                               \
+    void *children[VSTD_BTREE_NODE_CAP + 1];                                   \
+  } name##_inner;                                                              \
+                                                                               \
+  typedef struct name {                                                        \
+    void *root;                                                                \
+    name##_leaf *first;                                                        \
+    usize height;                                                              \
+    usize len;                                                                 \
+    const _VSTD_Allocator *alloc;                                              \
+  } name;                                                                      \
+                                                                               \
+  typedef struct name##_pair {                                                 \
+    K *key;                                                                    \
+    V *val;                                                                    \
+  } name##_pair;                                                               \
+                                                                               \
+  typedef struct name##_cursor {                                               \
+    name##_leaf *leaf;                                                         \
+    usize index;                                                               \
+  } name##_cursor;                                                             \
+                                                                               \
+  VSTD_INLINE name name##_with_allocator(const _VSTD_Allocator *allocator) {   \
+    return (name){                                                             \
+        .root = NULL,                                                          \
+        .first = NULL,                                                         \
+        .height = 0,                                                           \
+        .len = 0,                                                              \
+        .alloc = allocator,                                                    \
+    };                                                                         \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name name##_new(void) { return name##_with_allocator(NULL); }    \
+                                                                               \
+  VSTD_INLINE usize name##_len(const name *tree) { return tree->len; }         \
+                                                                               \
+  VSTD_INLINE name##_leaf *name##_find_leaf(const name *tree, K key) {         \
+    void *node = tree->root;                                                   \
+    for (usize height = tree->height; height > 0; --height) {                  \
+      name##_inner *inner = (name##_inner *)node;                              \
+      node = inner->children[name##_key_upper_bound(inner->keys, inner->len,   \
+                                                    key)];                     \
+    }                                                                          \
+    return (name##_leaf *)node;                                                \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC V *name##_get(const name *tree, K key) {                         \
+    if (!tree->root) {                                                         \
+      return NULL;                                                             \
+    }                                                                          \
+    name##_leaf *leaf = name##_find_leaf(tree, key);                           \
+    usize index;                                                               \
+    if (!name##_key_binary_search(leaf->keys, leaf->len, key, &index)) {       \
+      return NULL;                                                             \
+    }                                                                          \
+    return &leaf->vals[index];                                                 \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC bool name##_insert_leaf(name *tree, name##_leaf *leaf, K key,    \
+                                      V val, K *split_key, void **split) {     \
+    usize index;                                                               \
+    if (name##_key_binary_search(leaf->keys, leaf->len, key, &index)) {        \
+      leaf->vals[index] = val;                                                 \
+      return false;                                                            \
+    }                                                                          \
+                                                                               \
+    if (leaf->len == VSTD_BTREE_NODE_CAP) {                                    \
+      usize mid = VSTD_BTREE_NODE_CAP / 2;                                     \
+      name##_leaf *right =                                                     \
+          (name##_leaf *)vstd_alloc(tree->alloc, sizeof(name##_leaf));         \
+      right->len = VSTD_BTREE_NODE_CAP - mid;                                  \
+      memcpy(right->keys, leaf->keys + mid, sizeof(K) * right->len);           \
+      memcpy(right->vals, leaf->vals + mid, sizeof(V) * right->len);           \
+      right->next = leaf->next;                                                \
+      leaf->next = right;                                                      \
+      leaf->len = mid;                                                         \
+      *split_key = right->keys[0];                                             \
+      *split = right;                                                          \
+      if (index > mid) {                                                       \
+        index -= mid;                                                          \
+        leaf = right;                                                          \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    usize rest = leaf->len - index;                                            \
+    memmove(leaf->keys + index + 1, leaf->keys + index, sizeof(K) * rest);     \
+    memmove(leaf->vals + index + 1, leaf->vals + index, sizeof(V) * rest);     \
+    leaf->keys[index] = key;                                                   \
+    leaf->vals[index] = val;                                                   \
+    leaf->len++;                                                               \
+    return true;                                                               \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC bool name##_insert_node(name *tree, void *node, usize height,    \
+                                      K key, V val, K *split_key,              \
+                                      void **split) {                          \
+    *split = NULL;                                                             \
+    if (height == 0) {                                                         \
+      return name##_insert_leaf(tree, (name##_leaf *)node, key, val,           \
+                                split_key, split);                             \
+    }                                                                          \
+                                                                               \
+    name##_inner *inner = (name##_inner *)node;                                \
+    usize index = name##_key_upper_bound(inner->keys, inner->len, key);        \
+    K child_key;                                                               \
+    void *child;                                                               \
+    bool inserted = name##_insert_node(tree, inner->children[index],           \
+                                       height - 1, key, val, &child_key,       \
+                                       &child);                                \
+    if (!child) {                                                              \
+      return inserted;                                                         \
+    }                                                                          \
+                                                                               \
+    if (inner->len == VSTD_BTREE_NODE_CAP) {                                   \
+      usize mid = VSTD_BTREE_NODE_CAP / 2;                                     \
+      name##_inner *right =                                                    \
+          (name##_inner *)vstd_alloc(tree->alloc, sizeof(name##_inner));       \
+      right->len = VSTD_BTREE_NODE_CAP - mid - 1;                              \
+      memcpy(right->keys, inner->keys + mid + 1, sizeof(K) * right->len);      \
+      memcpy(right->children, inner->children + mid + 1,                       \
+             sizeof(void *) * (right->len + 1));                               \
+      inner->len = mid;                                                        \
+      *split_key = inner->keys[mid];                                           \
+      *split = right;                                                          \
+      if (index > mid) {                                                       \
+        index -= mid + 1;                                                      \
+        inner = right;                                                         \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    usize rest = inner->len - index;                                           \
+    memmove(inner->keys + index + 1, inner->keys + index, sizeof(K) * rest);   \
+    memmove(inner->children + index + 2, inner->children + index + 1,          \
+            sizeof(void *) * rest);                                            \
+    inner->keys[index] = child_key;                                            \
+    inner->children[index + 1] = child;                                        \
+    inner->len++;                                                              \
+    return inserted;                                                           \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC bool name##_set(name *tree, K key, V val) {                      \
+    if (!tree->root) {                                                         \
+      name##_leaf *leaf =                                                      \
+          (name##_leaf *)vstd_alloc(tree->alloc, sizeof(name##_leaf));         \
+      leaf->len = 0;                                                           \
+      leaf->next = NULL;                                                       \
+      tree->root = leaf;                                                       \
+      tree->first = leaf;                                                      \
+    }                                                                          \
+                                                                               \
+    K split_key;                                                               \
+    void *split;                                                               \
+    bool inserted = name##_insert_node(tree, tree->root, tree->height, key,    \
+                                       val, &split_key, &split);               \
+    if (split) {                                                               \
+      name##_inner *root =                                                     \
+          (name##_inner *)vstd_alloc(tree->alloc, sizeof(name##_inner));       \
+      root->len = 1;                                                           \
+      root->keys[0] = split_key;                                               \
+      root->children[0] = tree->root;                                          \
+      root->children[1] = split;                                               \
+      tree->root = root;                                                       \
+      tree->height++;                                                          \
+    }                                                                          \
+    tree->len += inserted;                                                     \
+    return inserted;                                                           \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_merge(name *tree, name##_inner *parent, usize index, \
+                                usize height) {                                \
+    if (height == 0) {                                                         \
+      name##_leaf *left = (name##_leaf *)parent->children[index];              \
+      name##_leaf *right = (name##_leaf *)parent->children[index + 1];         \
+      memcpy(left->keys + left->len, right->keys, sizeof(K) * right->len);     \
+      memcpy(left->vals + left->len, right->vals, sizeof(V) * right->len);     \
+      left->len += right->len;                                                 \
+      left->next = right->next;                                                \
+      vstd_free(tree->alloc, right, sizeof(name##_leaf));                      \
+    } else {                                                                   \
+      name##_inner *left = (name##_inner *)parent->children[index];            \
+      name##_inner *right = (name##_inner *)parent->children[index + 1];       \
+      left->keys[left->len] = parent->keys[index];                             \
+      memcpy(left->keys + left->len + 1, right->keys,                          \
+             sizeof(K) * right->len);                                          \
+      memcpy(left->children + left->len + 1, right->children,                  \
+             sizeof(void *) * (right->len + 1));                               \
+      left->len += right->len + 1;                                             \
+      vstd_free(tree->alloc, right, sizeof(name##_inner));                     \
+    }                                                                          \
+                                                                               \
+    usize rest = parent->len - index - 1;                                      \
+    memmove(parent->keys + index, parent->keys + index + 1, sizeof(K) * rest); \
+    memmove(parent->children + index + 1, parent->children + index + 2,        \
+            sizeof(void *) * rest);                                            \
+    parent->len--;                                                             \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_rebalance_leaf(name *tree, name##_inner *parent,     \
+                                         usize index) {                        \
+    name##_leaf *child = (name##_leaf *)parent->children[index];               \
+    if (child->len >= _VSTD_BTREE_MIN_LEAF) {                                  \
+      return;                                                                  \
+    }                                                                          \
+                                                                               \
+    name##_leaf *left =                                                        \
+        index > 0 ? (name##_leaf *)parent->children[index - 1] : NULL;         \
+    name##_leaf *right = index < parent->len                                   \
+                             ? (name##_leaf *)parent->children[index + 1]      \
+                             : NULL;                                           \
+    if (left && left->len > _VSTD_BTREE_MIN_LEAF) {                            \
+      memmove(child->keys + 1, child->keys, sizeof(K) * child->len);           \
+      memmove(child->vals + 1, child->vals, sizeof(V) * child->len);           \
+      left->len--;                                                             \
+      child->keys[0] = left->keys[left->len];                                  \
+      child->vals[0] = left->vals[left->len];                                  \
+      child->len++;                                                            \
+      parent->keys[index - 1] = child->keys[0];                                \
+    } else if (right && right->len > _VSTD_BTREE_MIN_LEAF) {                   \
+      child->keys[child->len] = right->keys[0];                                \
+      child->vals[child->len] = right->vals[0];                                \
+      child->len++;                                                            \
+      right->len--;                                                            \
+      memmove(right->keys, right->keys + 1, sizeof(K) * right->len);           \
+      memmove(right->vals, right->vals + 1, sizeof(V) * right->len);           \
+      parent->keys[index] = right->keys[0];                                    \
+    } else if (left) {                                                         \
+      name##_merge(tree, parent, index - 1, 0);                                \
+    } else if (right) {                                                        \
+      name##_merge(tree, parent, index, 0);                                    \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_rebalance_inner(name *tree, name##_inner *parent,    \
+                                          usize index, usize height) {         \
+    name##_inner *child = (name##_inner *)parent->children[index];             \
+    if (child->len >= _VSTD_BTREE_MIN_INNER) {                                 \
+      return;                                                                  \
+    }                                                                          \
+                                                                               \
+    name##_inner *left =                                                       \
+        index > 0 ? (name##_inner *)parent->children[index - 1] : NULL;        \
+    name##_inner *right = index < parent->len                                  \
+                              ? (name##_inner *)parent->children[index + 1]    \
+                              : NULL;                                          \
+    if (left && left->len > _VSTD_BTREE_MIN_INNER) {                           \
+      memmove(child->keys + 1, child->keys, sizeof(K) * child->len);           \
+      memmove(child->children + 1, child->children,                            \
+              sizeof(void *) * (child->len + 1));                              \
+      child->keys[0] = parent->keys[index - 1];                                \
+      child->children[0] = left->children[left->len];                          \
+      child->len++;                                                            \
+      left->len--;                                                             \
+      parent->keys[index - 1] = left->keys[left->len];                         \
+    } else if (right && right->len > _VSTD_BTREE_MIN_INNER) {                  \
+      child->keys[child->len] = parent->keys[index];                           \
+      child->children[child->len + 1] = right->children[0];                    \
+      child->len++;                                                            \
+      parent->keys[index] = right->keys[0];                                    \
+      right->len--;                                                            \
+      memmove(right->keys, right->keys + 1, sizeof(K) * right->len);           \
+      memmove(right->children, right->children + 1,                            \
+              sizeof(void *) * (right->len + 1));                              \
+    } else if (left) {                                                         \
+      name##_merge(tree, parent, index - 1, height);                           \
+    } else if (right) {                                                        \
+      name##_merge(tree, parent, index, height);                               \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC bool name##_remove_node(name *tree, void *node, usize height,    \
+                                      K key, V *out) {                         \
+    if (height == 0) {                                                         \
+      name##_leaf *leaf = (name##_leaf *)node;                                 \
+      usize index;                                                             \
+      if (!name##_key_binary_search(leaf->keys, leaf->len, key, &index)) {     \
+        return false;                                                          \
+      }                                                                        \
+      if (out) {                                                               \
+        *out = leaf->vals[index];                                              \
+      }                                                                        \
+      leaf->len--;                                                             \
+      usize rest = leaf->len - index;                                          \
+      memmove(leaf->keys + index, leaf->keys + index + 1, sizeof(K) * rest);   \
+      memmove(leaf->vals + index, leaf->vals + index + 1, sizeof(V) * rest);   \
+      return true;                                                             \
+    }                                                                          \
+                                                                               \
+    name##_inner *inner = (name##_inner *)node;                                \
+    usize index = name##_key_upper_bound(inner->keys, inner->len, key);        \
+    if (!name##_remove_node(tree, inner->children[index], height - 1, key,     \
+                            out)) {                                            \
+      return false;                                                            \
+    }                                                                          \
+    if (height == 1) {                                                         \
+      name##_rebalance_leaf(tree, inner, index);                               \
+    } else {                                                                   \
+      name##_rebalance_inner(tree, inner, index, height - 1);                  \
+    }                                                                          \
+    return true;                                                               \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC bool name##_remove(name *tree, K key, V *out) {                  \
+    if (!tree->root ||                                                         \
+        !name##_remove_node(tree, tree->root, tree->height, key, out)) {       \
+      return false;                                                            \
+    }                                                                          \
+                                                                               \
+    tree->len--;                                                               \
+    name##_inner *root = (name##_inner *)tree->root;                           \
+    if (tree->height > 0 && root->len == 0) {                                  \
+      tree->root = root->children[0];                                          \
+      tree->height--;                                                          \
+      vstd_free(tree->alloc, root, sizeof(name##_inner));                      \
+    }                                                                          \
+    return true;                                                               \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name##_cursor name##_cursor_fix(name##_cursor cursor) {          \
+    if (cursor.leaf && cursor.index == cursor.leaf->len) {                     \
+      cursor.leaf = cursor.leaf->next;                                         \
+      cursor.index = 0;                                                        \
+    }                                                                          \
+    return cursor;                                                             \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name##_cursor name##_begin(const name *tree) {                   \
+    name##_cursor cursor = {.leaf = tree->first, .index = 0};                  \
+    return name##_cursor_fix(cursor);                                          \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC name##_cursor name##_lower_bound(const name *tree, K key) {      \
+    if (!tree->root) {                                                         \
+      return (name##_cursor){.leaf = NULL, .index = 0};                        \
+    }                                                                          \
+    name##_leaf *leaf = name##_find_leaf(tree, key);                           \
+    return name##_cursor_fix((name##_cursor){                                  \
+        .leaf = leaf,                                                          \
+        .index = name##_key_lower_bound(leaf->keys, leaf->len, key),           \
+    });                                                                        \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name##_cursor name##_range(const name *tree, K lo, K hi,         \
+                                         name##_cursor *end) {                 \
+    name##_cursor begin = name##_lower_bound(tree, lo);                        \
+    *end = less(lo, hi) ? name##_lower_bound(tree, hi) : begin;                \
+    return begin;                                                              \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE void name##_cursor_next(name##_cursor *cursor) {                 \
+    cursor->index++;                                                           \
+    *cursor = name##_cursor_fix(*cursor);                                      \
+  }                                                                            \
+                                                                               \
+  VSTD_INLINE name##_pair name##_cursor_get(name##_cursor cursor) {            \
+    return (name##_pair){                                                      \
+        .key = &cursor.leaf->keys[cursor.index],                               \
+        .val = &cursor.leaf->vals[cursor.index],                               \
+    };                                                                         \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_free_node(name *tree, void *node, usize height) {    \
+    if (height == 0) {                                                         \
+      vstd_free(tree->alloc, node, sizeof(name##_leaf));                       \
+      return;                                                                  \
+    }                                                                          \
+    name##_inner *inner = (name##_inner *)node;                                \
+    for (usize i = 0; i <= inner->len; ++i) {                                  \
+      name##_free_node(tree, inner->children[i], height - 1);                  \
+    }                                                                          \
+    vstd_free(tree->alloc, inner, sizeof(name##_inner));                       \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_clear(name *tree) {                                  \
+    if (tree->root) {                                                          \
+      name##_free_node(tree, tree->root, tree->height);                        \
+    }                                                                          \
+    tree->root = NULL;                                                         \
+    tree->first = NULL;                                                        \
+    tree->height = 0;                                                          \
+    tree->len = 0;                                                             \
+  }                                                                            \
+                                                                               \
+  VSTD_STATIC void name##_free(name *tree) { name##_clear(tree); }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_btree_iter
+ *
+ * @description
+ *   Iterates trough the keys and values of a B+tree in ascending order of the
+ *   keys, by walking the linked leaves. In every iteration it is possible to
+ *   access the current key and value from _$iter and current index from _$i.
+ *
+ * @param[in]
+ *   name : Name passed to VSTD_BTREE_DEFINE.
+ * @param[in]
+ *   tree : B+tree to iterate.
+ * @param[in]
+ *   ... : A single function or a block of code to execute every iteration.
+ *
+ * */
+#define vstd_btree_iter(name, tree, ...)                                       \
+  do {                                                                         \
+    name##_cursor _cursor = name##_begin(&(tree));                             \
+    for (usize _$i = 0; _cursor.leaf; ++_$i, name##_cursor_next(&_cursor)) {   \
+      name##_pair _$iter = name##_cursor_get(_cursor);                         \
+      __VA_ARGS__;                                                             \
+      (void)(_$i);                                                             \
+      (void)(_$iter);                                                          \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_btree_range
+ *
+ * @description
+ *   Same as vstd_btree_iter, but only iterates the keys which are not less
+ *   than lo and less than hi. _$i counts the iterated keys.
+ *
+ * @param[in]
+ *   name : Name passed to VSTD_BTREE_DEFINE.
+ * @param[in]
+ *   tree : B+tree to iterate.
+ * @param[in]
+ *   lo : Lower bound of the keys, inclusive.
+ * @param[in]
+ *   hi : Upper bound of the keys, exclusive.
+ * @param[in]
+ *   ... : A single function or a block of code to execute every iteration.
+ *
+ * */
+#define vstd_btree_range(name, tree, lo, hi, ...)                              \
+  do {                                                                         \
+    name##_cursor _end;                                                        \
+    name##_cursor _cursor = name##_range(&(tree), lo, hi, &_end);              \
+    for (usize _$i = 0;                                                        \
+         _cursor.leaf != _end.leaf || _cursor.index != _end.index;             \
+         ++_$i, name##_cursor_next(&_cursor)) {                                \
+      name##_pair _$iter = name##_cursor_get(_cursor);                         \
+      __VA_ARGS__;                                                             \
+      (void)(_$i);                                                             \
+      (void)(_$iter);                                                          \
+    }                                                                          \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD ThreadPool
+ *
+ * @description
+ *   Work stealing thread pool for data parallel loops over index ranges. The
+ *   range of a loop is split in halves until it's no larger than the grain
+ *   size, every worker pushes the halves it doesn't run to its own Chase-Lev
+ *   deque, and idle workers steal the oldest, largest halves from the others.
+ *   The thread calling a parallel loop takes part in it, so a pool created
+ *   with N threads starts N - 1 workers.
+ *
+ * */
+
+#ifndef VSTD_THREAD_POOL_DEQUE_CAP
+#define VSTD_THREAD_POOL_DEQUE_CAP 128
+#endif
+
+#ifndef VSTD_THREAD_POOL_ALIGNMENT
+#define VSTD_THREAD_POOL_ALIGNMENT 64
+#endif
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_WorkDeque
+ *
+ * @description:
+ *   Chase-Lev deque of index ranges owned by a single worker, which pushes and
+ *   takes ranges at the bottom, while the other workers steal them from the
+ *   top. Splitting halves the ranges, so a deque never holds more than a range
+ *   per bit of usize, and the deque doesn't have to grow. Ranges are stored as
+ *   atomics, because a thief may read a slot the owner is writing, in which
+ *   case the thief's compare-and-swap fails and the read is discarded.
+ *
+ * */
+struct _VSTD_WorkDeque {
+  _Alignas(VSTD_THREAD_POOL_ALIGNMENT) _Atomic isize top;
+  _Alignas(VSTD_THREAD_POOL_ALIGNMENT) _Atomic isize bottom;
+  struct _VSTD_ThreadPool *pool;
+  usize index;
+  u64 seed;
+  struct {
+    _Atomic usize begin;
+    _Atomic usize end;
+  } ranges[VSTD_THREAD_POOL_DEQUE_CAP];
+};
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_ThreadPool
+ *
+ * @description:
+ *   Thread pool implementation. deques holds a deque for every worker, plus
+ *   deque 0 for the thread calling the parallel loops. Parallel loops on the
+ *   same pool run one at a time, and they can't be started from inside a
+ *   loop's body.
+ *
+ * */
+struct _VSTD_ThreadPool {
+  pthread_t *threads;
+  struct _VSTD_WorkDeque *deques;
+  void *block;
+  usize workers;
+  pthread_mutex_t run;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_cond_t done;
+  usize generation;
+  usize active;
+  bool stop;
+  void (*body)(void *ctx, usize worker, usize begin, usize end);
+  void *ctx;
+  usize grain;
+  _Atomic usize remaining;
+};
+
+#ifdef VSTD_THREAD_POOL_STRIP_PREFIX
+typedef struct _VSTD_ThreadPool ThreadPool;
+#define _VSTD_ThreadPool ThreadPool
+#else
+typedef struct _VSTD_ThreadPool VSTD_ThreadPool;
+#define _VSTD_ThreadPool VSTD_ThreadPool
+#endif
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_work_push
+ *
+ * @description
+ *   Pushes a range to the bottom of a deque, only the deque's owner may call
+ *   it. This is a helper function and it's only meant to be used the vstd
+ *   library functions.
+ *
+ * @param[in]
+ *   deque : Deque to push to.
+ * @param[in]
+ *   begin : First index of the range.
+ * @param[in]
+ *   end : Index after the last index of the range.
+ *
+ * */
+VSTD_INLINE void _vstd_work_push(struct _VSTD_WorkDeque *deque, usize begin,
+                                 usize end) {
+  isize bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+  usize slot = (usize)bottom & (VSTD_THREAD_POOL_DEQUE_CAP - 1);
+  atomic_store_explicit(&deque->ranges[slot].begin, begin,
+                        memory_order_relaxed);
+  atomic_store_explicit(&deque->ranges[slot].end, end, memory_order_relaxed);
+  atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_work_take
+ *
+ * @description
+ *   Takes the range at the bottom of a deque, only the deque's owner may call
+ *   it. This is a helper function and it's only meant to be used the vstd
+ *   library functions.
+ *
+ * @param[in]
+ *   deque : Deque to take from.
+ * @param[out]
+ *   begin : First index of the range.
+ * @param[out]
+ *   end : Index after the last index of the range.
+ *
+ * @return
+ *   false if the deque was empty, true otherwise.
+ *
+ * */
+VSTD_STATIC bool _vstd_work_take(struct _VSTD_WorkDeque *deque, usize *begin,
+                                 usize *end) {
+  isize bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+  atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  isize top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+  if (top > bottom) {
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return false;
+  }
+
+  usize slot = (usize)bottom & (VSTD_THREAD_POOL_DEQUE_CAP - 1);
+  *begin = atomic_load_explicit(&deque->ranges[slot].begin,
+                                memory_order_relaxed);
+  *end = atomic_load_explicit(&deque->ranges[slot].end, memory_order_relaxed);
+  if (top == bottom) {
+    bool won = atomic_compare_exchange_strong_explicit(
+        &deque->top, &top, top + 1, memory_order_seq_cst,
+        memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return won;
+  }
+  return true;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_work_steal
+ *
+ * @description
+ *   Steals the range at the top of another worker's deque. This is a helper
+ *   function and it's only meant to be used the vstd library functions.
+ *
+ * @param[in]
+ *   deque : Deque to steal from.
+ * @param[out]
+ *   begin : First index of the range.
+ * @param[out]
+ *   end : Index after the last index of the range.
+ *
+ * @return
+ *   false if the deque was empty or another thread won the range, true
+ *   otherwise.
+ *
+ * */
+VSTD_STATIC bool _vstd_work_steal(struct _VSTD_WorkDeque *deque, usize *begin,
+                                  usize *end) {
+  isize top = atomic_load_explicit(&deque->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  isize bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+  if (top >= bottom) {
+    return false;
+  }
+
+  usize slot = (usize)top & (VSTD_THREAD_POOL_DEQUE_CAP - 1);
+  *begin = atomic_load_explicit(&deque->ranges[slot].begin,
+                                memory_order_relaxed);
+  *end = atomic_load_explicit(&deque->ranges[slot].end, memory_order_relaxed);
+  return atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                 memory_order_seq_cst,
+                                                 memory_order_relaxed);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_thread_pool_run_range
+ *
+ * @description
+ *   Splits the range in halves, pushing the upper halves to the worker's deque
+ *   until the range is no larger than the grain size, then runs the loop body
+ *   on it. This is a helper function and it's only meant to be used the vstd
+ *   library functions.
+ *
+ * @param[in]
+ *   deque : Deque of the worker running the range.
+ * @param[in]
+ *   begin : First index of the range.
+ * @param[in]
+ *   end : Index after the last index of the range.
+ *
+ * */
+VSTD_STATIC void _vstd_thread_pool_run_range(struct _VSTD_WorkDeque *deque,
+                                             usize begin, usize end) {
+  _VSTD_ThreadPool *pool = deque->pool;
+  while (end - begin > pool->grain) {
+    usize mid = begin + (end - begin) / 2;
+    _vstd_work_push(deque, mid, end);
+    end = mid;
+  }
+  pool->body(pool->ctx, deque->index, begin, end);
+  atomic_fetch_sub_explicit(&pool->remaining, end - begin,
+                            memory_order_release);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_thread_pool_work
+ *
+ * @description
+ *   Runs the ranges of the worker's own deque, and steals ranges from random
+ *   workers when it's empty, until every index of the loop has been run. This
+ *   is a helper function and it's only meant to be used the vstd library
+ *   functions.
+ *
+ * @param[in]
+ *   deque : Deque of the worker.
+ *
+ * */
+VSTD_STATIC void _vstd_thread_pool_work(struct _VSTD_WorkDeque *deque) {
+  _VSTD_ThreadPool *pool = deque->pool;
+  usize count = pool->workers + 1;
+  usize begin, end, idle = 0;
+
+  while (atomic_load_explicit(&pool->remaining, memory_order_acquire)) {
+    if (_vstd_work_take(deque, &begin, &end)) {
+      _vstd_thread_pool_run_range(deque, begin, end);
+      continue;
+    }
+
+    deque->seed ^= deque->seed << 13;
+    deque->seed ^= deque->seed >> 7;
+    deque->seed ^= deque->seed << 17;
+    usize victim = (usize)(deque->seed % count);
+    bool stolen = false;
+    for (usize i = 0; i < count && !stolen; ++i) {
+      if (victim != deque->index) {
+        stolen = _vstd_work_steal(&pool->deques[victim], &begin, &end);
+      }
+      victim = victim + 1 < count ? victim + 1 : 0;
+    }
+
+    if (stolen) {
+      idle = 0;
+      _vstd_thread_pool_run_range(deque, begin, end);
+    } else if (++idle % 64 == 0) {
+      sched_yield();
+    } else {
+#if defined(__SSE2__)
+      _mm_pause();
+#endif
+    }
+  }
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_thread_pool_worker
+ *
+ * @description
+ *   Main function of the worker threads, which sleep until a parallel loop is
+ *   started, and take part in every loop until the pool is freed. This is a
+ *   helper function and it's only meant to be used the vstd library
+ *   functions.
+ *
+ * @param[in]
+ *   arg : Deque of the worker.
+ *
+ * */
+VSTD_STATIC void *_vstd_thread_pool_worker(void *arg) {
+  struct _VSTD_WorkDeque *deque = (struct _VSTD_WorkDeque *)arg;
+  _VSTD_ThreadPool *pool = deque->pool;
+  usize generation = 0;
+
+  pthread_mutex_lock(&pool->lock);
+  for (;;) {
+    while (!pool->stop && pool->generation == generation) {
+      pthread_cond_wait(&pool->wake, &pool->lock);
+    }
+    if (pool->stop) {
+      break;
+    }
+    generation = pool->generation;
+    pthread_mutex_unlock(&pool->lock);
+
+    _vstd_thread_pool_work(deque);
+
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->active == 0) {
+      pthread_cond_signal(&pool->done);
+    }
+  }
+  pthread_mutex_unlock(&pool->lock);
+
+  return NULL;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_thread_pool_new
+ *
+ * @description
+ *   Creates a new thread pool, and starts its workers. If a worker can't be
+ *   started, the pool runs with the workers started so far.
+ *
+ * @param[in]
+ *   threads : Number of threads running the parallel loops, including the
+ *             calling thread, 0 uses the number of online processors.
+ *
+ * @return
+ *   Pointer to the new _VSTD_ThreadPool, which has to be freed with
+ *   vstd_thread_pool_free.
+ *
+ * */
+VSTD_STATIC _VSTD_ThreadPool *vstd_thread_pool_new(usize threads) {
+  threads = _vstd_sort_threads(threads);
+
+  _VSTD_ThreadPool *pool =
+      (_VSTD_ThreadPool *)VSTD_CALLOC(1, sizeof(_VSTD_ThreadPool));
+  pool->threads = (pthread_t *)VSTD_MALLOC(sizeof(pthread_t) * threads);
+  pool->block = VSTD_CALLOC(1, sizeof(struct _VSTD_WorkDeque) * threads +
+                                   VSTD_THREAD_POOL_ALIGNMENT);
+  pool->deques = (struct _VSTD_WorkDeque *)(((uptr)pool->block +
+                                             VSTD_THREAD_POOL_ALIGNMENT - 1) &
+                                            ~(uptr)(VSTD_THREAD_POOL_ALIGNMENT -
+                                                    1));
+  pthread_mutex_init(&pool->run, NULL);
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->wake, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  atomic_init(&pool->remaining, 0);
+
+  for (usize i = 0; i < threads; ++i) {
+    struct _VSTD_WorkDeque *deque = &pool->deques[i];
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    deque->pool = pool;
+    deque->index = i;
+    deque->seed = 0x9E3779B97F4A7C15ull * (i + 1);
+  }
+
+  for (usize i = 1; i < threads; ++i) {
+    if (pthread_create(&pool->threads[i - 1], NULL, _vstd_thread_pool_worker,
+                       &pool->deques[pool->workers + 1])) {
+      break;
+    }
+    pool->workers++;
+  }
+
+  return pool;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_thread_pool_free
+ *
+ * @description
+ *   Stops and joins the workers of the pool, and frees it.
+ *
+ * @param[in]
+ *   pool : Pointer to _VSTD_ThreadPool to free.
+ *
+ * */
+VSTD_STATIC void vstd_thread_pool_free(_VSTD_ThreadPool *pool) {
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = true;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (usize i = 0; i < pool->workers; ++i) {
+    pthread_join(pool->threads[i], NULL);
+  }
+
+  pthread_cond_destroy(&pool->done);
+  pthread_cond_destroy(&pool->wake);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_mutex_destroy(&pool->run);
+  VSTD_FREE(pool->block);
+  VSTD_FREE(pool->threads);
+  VSTD_FREE(pool);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_thread_pool_threads
+ *
+ * @description
+ *   Returns the number of threads running the parallel loops of the pool,
+ *   including the calling thread. Worker indices passed to the loop bodies
+ *   are smaller than it.
+ *
+ * @param[in]
+ *   pool : _VSTD_ThreadPool to query.
+ *
+ * @return
+ *   Number of threads.
+ *
+ * */
+VSTD_INLINE usize vstd_thread_pool_threads(const _VSTD_ThreadPool *pool) {
+  return pool->workers + 1;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_thread_pool_run
+ *
+ * @description
+ *   Runs body on the range [0, len) split into ranges of at most grain items,
+ *   and returns when all of them have been run. This is a helper function and
+ *   it's only meant to be used the vstd library functions.
+ *
+ * @param[in]
+ *   pool : _VSTD_ThreadPool to run the loop on.
+ * @param[in]
+ *   len : Number of indices.
+ * @param[in]
+ *   grain : Largest range run at once, 0 picks one from len.
+ * @param[in]
+ *   body : Function called with the worker index and a range.
+ * @param[in]
+ *   ctx : Pointer passed to body.
+ *
+ * */
+VSTD_STATIC void _vstd_thread_pool_run(_VSTD_ThreadPool *pool, usize len,
+                                       usize grain,
+                                       void (*body)(void *ctx, usize worker,
+                                                    usize begin, usize end),
+                                       void *ctx) {
+  if (len == 0) {
+    return;
+  }
+  if (grain == 0) {
+    grain = len / (vstd_thread_pool_threads(pool) * 8);
+    grain = grain ? grain : 1;
+  }
+  if (pool->workers == 0 || len <= grain) {
+    body(ctx, 0, 0, len);
+    return;
+  }
+
+  pthread_mutex_lock(&pool->run);
+  pool->body = body;
+  pool->ctx = ctx;
+  pool->grain = grain;
+  atomic_store_explicit(&pool->remaining, len, memory_order_relaxed);
+  _vstd_work_push(&pool->deques[0], 0, len);
+
+  pthread_mutex_lock(&pool->lock);
+  pool->active = pool->workers;
+  pool->generation++;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->lock);
+
+  _vstd_thread_pool_work(&pool->deques[0]);
+
+  pthread_mutex_lock(&pool->lock);
+  while (pool->active) {
+    pthread_cond_wait(&pool->done, &pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  pthread_mutex_unlock(&pool->run);
+}
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_ParallelFor
+ *
+ * @description:
+ *   Loop state of vstd_parallel_for.
+ *
+ * */
+struct _VSTD_ParallelFor {
+  void (*fn)(void *ctx, usize begin, usize end);
+  void *ctx;
+};
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_parallel_for_body
+ *
+ * @description
+ *   Loop body of vstd_parallel_for, which drops the worker index. This is a
+ *   helper function and it's only meant to be used the vstd library
+ *   functions.
+ *
+ * */
+VSTD_STATIC void _vstd_parallel_for_body(void *ctx, usize worker, usize begin,
+                                         usize end) {
+  struct _VSTD_ParallelFor *loop = (struct _VSTD_ParallelFor *)ctx;
+  (void)worker;
+  loop->fn(loop->ctx, begin, end);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_parallel_for
+ *
+ * @description
+ *   Calls fn on ranges covering [0, len) from the threads of the pool, and
+ *   returns when all of them have been run. Each range holds at most grain
+ *   indices, smaller grains balance the load better, larger ones cost less
+ *   scheduling.
+ *
+ * @param[in]
+ *   pool : _VSTD_ThreadPool to run the loop on.
+ * @param[in]
+ *   len : Number of indices.
+ * @param[in]
+ *   grain : Largest range run at once, 0 picks one from len.
+ * @param[in]
+ *   fn : Function called with ctx and every range, [begin, end).
+ * @param[in]
+ *   ctx : Pointer passed to fn.
+ *
+ * */
+VSTD_STATIC void vstd_parallel_for(_VSTD_ThreadPool *pool, usize len,
+                                   usize grain,
+                                   void (*fn)(void *ctx, usize begin,
+                                              usize end),
+                                   void *ctx) {
+  struct _VSTD_ParallelFor loop = {.fn = fn, .ctx = ctx};
+  _vstd_thread_pool_run(pool, len, grain, _vstd_parallel_for_body, &loop);
+}
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_ParallelReduce
+ *
+ * @description:
+ *   Loop state of vstd_parallel_reduce.
+ *
+ * */
+struct _VSTD_ParallelReduce {
+  void (*fn)(void *ctx, usize begin, usize end, void *acc);
+  void *ctx;
+  u8 *accs;
+  usize stride;
+};
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_parallel_reduce_body
+ *
+ * @description
+ *   Loop body of vstd_parallel_reduce, which passes the worker's accumulator.
+ *   This is a helper function and it's only meant to be used the vstd library
+ *   functions.
+ *
+ * */
+VSTD_STATIC void _vstd_parallel_reduce_body(void *ctx, usize worker,
+                                            usize begin, usize end) {
+  struct _VSTD_ParallelReduce *loop = (struct _VSTD_ParallelReduce *)ctx;
+  loop->fn(loop->ctx, begin, end, loop->accs + loop->stride * worker);
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_parallel_reduce
+ *
+ * @description
+ *   Same as vstd_parallel_for, but every thread accumulates its ranges into
+ *   its own copy of acc, kept on separate cache lines. When the loop is done,
+ *   the copies are merged into acc with combine, in thread order.
+ *
+ * @param[in]
+ *   pool : _VSTD_ThreadPool to run the loop on.
+ * @param[in]
+ *   len : Number of indices.
+ * @param[in]
+ *   grain : Largest range run at once, 0 picks one from len.
+ * @param[in/out]
+ *   acc : Accumulator, holding the identity value when called and the result
+ *         when it returns.
+ * @param[in]
+ *   size : Size of the accumulator.
+ * @param[in]
+ *   fn : Function accumulating the range [begin, end) into acc.
+ * @param[in]
+ *   combine : Function merging the accumulator other into acc.
+ * @param[in]
+ *   ctx : Pointer passed to fn and combine.
+ *
+ * */
+VSTD_STATIC void vstd_parallel_reduce(
+    _VSTD_ThreadPool *pool, usize len, usize grain, void *acc, usize size,
+    void (*fn)(void *ctx, usize begin, usize end, void *acc),
+    void (*combine)(void *ctx, void *acc, const void *other), void *ctx) {
+  usize threads = vstd_thread_pool_threads(pool);
+  usize stride = (size + VSTD_THREAD_POOL_ALIGNMENT - 1) &
+                 ~(usize)(VSTD_THREAD_POOL_ALIGNMENT - 1);
+  u8 *block = (u8 *)VSTD_MALLOC(stride * threads + VSTD_THREAD_POOL_ALIGNMENT);
+  u8 *accs = (u8 *)(((uptr)block + VSTD_THREAD_POOL_ALIGNMENT - 1) &
+                    ~(uptr)(VSTD_THREAD_POOL_ALIGNMENT - 1));
+  for (usize i = 0; i < threads; ++i) {
+    memcpy(accs + stride * i, acc, size);
+  }
+
+  struct _VSTD_ParallelReduce loop = {
+      .fn = fn, .ctx = ctx, .accs = accs, .stride = stride};
+  _vstd_thread_pool_run(pool, len, grain, _vstd_parallel_reduce_body, &loop);
+
+  memcpy(acc, accs, size);
+  for (usize i = 1; i < threads; ++i) {
+    combine(ctx, acc, accs + stride * i);
+  }
+  VSTD_FREE(block);
+}
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_ParallelIter
+ *
+ * @description:
+ *   Loop state of vstd_vector_par_iter and vstd_map_par_iter.
+ *
+ * */
+struct _VSTD_ParallelIter {
+  void (*fn)(void *ctx, void *item, void *val, usize index);
+  void *ctx;
+  u8 *items;
+  usize size;
+  u8 *vals;
+  usize val_size;
+};
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_parallel_iter_body
+ *
+ * @description
+ *   Loop body of vstd_vector_par_iter and vstd_map_par_iter, which calls the
+ *   item function on every item of the range. This is a helper function and
+ *   it's only meant to be used the vstd library functions.
+ *
+ * */
+VSTD_STATIC void _vstd_parallel_iter_body(void *ctx, usize worker,
+                                          usize begin, usize end) {
+  struct _VSTD_ParallelIter *loop = (struct _VSTD_ParallelIter *)ctx;
+  (void)worker;
+  for (usize i = begin; i < end; ++i) {
+    loop->fn(loop->ctx, loop->items + loop->size * i,
+             loop->vals ? loop->vals + loop->val_size * i : NULL, i);
+  }
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_parallel_iter
+ *
+ * @description
+ *   Runs fn on every item of one or two parallel arrays from the threads of
+ *   the pool. This is a helper function and it's only meant to be used the
+ *   vstd library functions.
+ *
+ * */
+VSTD_STATIC void _vstd_parallel_iter(
+    _VSTD_ThreadPool *pool, usize len, usize grain, void *items, usize size,
+    void *vals, usize val_size,
+    void (*fn)(void *ctx, void *item, void *val, usize index), void *ctx) {
+  struct _VSTD_ParallelIter loop = {
+      .fn = fn,
+      .ctx = ctx,
+      .items = (u8 *)items,
+      .size = size,
+      .vals = (u8 *)vals,
+      .val_size = val_size,
+  };
+  _vstd_thread_pool_run(pool, len, grain, _vstd_parallel_iter_body, &loop);
+}
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_vector_par_iter
+ *
+ * @description
+ *   Parallel version of vstd_vector_iter, which calls fn on every item of the
+ *   _VSTD_Vector from the threads of the pool. The items are visited in no
+ *   particular order, and fn may only modify the item it's called with.
+ *
+ * @param[in]
+ *   type : Type of the _VSTD_Vector's data.
+ * @param[in]
+ *   pool : _VSTD_ThreadPool to run the loop on.
+ * @param[in]
+ *   vec : _VSTD_Vector to iterate.
+ * @param[in]
+ *   grain : Largest number of items run at once, 0 picks one from the length.
+ * @param[in]
+ *   fn : Function called as fn(ctx, item, NULL, index), where item points to
+ *        the item as a void *.
+ * @param[in]
+ *   ctx : Pointer passed to fn.
+ *
+ * */
+#define vstd_vector_par_iter(type, pool, vec, grain, fn, ctx)                  \
+  _vstd_parallel_iter(pool, (vec).len, grain, (vec).ptr, sizeof(type), NULL,   \
+                      0, fn, ctx)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_map_par_iter
+ *
+ * @description
+ *   Parallel version of vstd_map_iter, which calls fn on every entry of the
+ *   _VSTD_Map from the threads of the pool. The entries are visited in no
+ *   particular order, and fn may only modify the value it's called with.
+ *
+ * @param[in]
+ *   k : Type of the _VSTD_Map's keys.
+ * @param[in]
+ *   v : Type of the _VSTD_Map's values.
+ * @param[in]
+ *   pool : _VSTD_ThreadPool to run the loop on.
+ * @param[in]
+ *   map : _VSTD_Map to iterate.
+ * @param[in]
+ *   grain : Largest number of entries run at once, 0 picks one from the
+ *           length.
+ * @param[in]
+ *   fn : Function called as fn(ctx, key, val, index), where key and val point
+ *        to the entry as void *.
+ * @param[in]
+ *   ctx : Pointer passed to fn.
+ *
+ * */
+#define vstd_map_par_iter(k, v, pool, map, grain, fn, ctx)                     \
+  _vstd_parallel_iter(pool, (map).keys.len, grain, (map).keys.ptr, sizeof(k),  \
+                      (map).vals.ptr, sizeof(v), fn, ctx)
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Interner
+ *
+ * @description
+ *   String interning table, which stores every unique string once and maps it
+ *   to a small integer ID, so interned strings can be compared by their IDs.
+ *   The characters are copied to arenas, so the interned strings never move
+ *   and their views stay valid until the interner is freed.
+ *
+ * */
+
+#ifndef VSTD_INTERNER_ALIGNMENT
+#define VSTD_INTERNER_ALIGNMENT 64
+#endif
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_InternerShard
+ *
+ * @description:
+ *   Part of an interner, with its own arena, map and lock. The map's keys are
+ *   the interned strings in insertion order, so an ID's string is found by
+ *   indexing the keys.
+ *
+ * */
+struct _VSTD_InternerShard {
+  _Alignas(VSTD_INTERNER_ALIGNMENT) pthread_mutex_t lock;
+  _VSTD_Arena arena;
+  struct _VSTD_Map map;
+};
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_Interner
+ *
+ * @description:
+ *   Interner implementation. A sharded interner picks the shard of a string
+ *   from its hash and locks only that shard, so threads interning different
+ *   strings rarely wait for each other. The low bits of an ID select its
+ *   shard, and the others index the shard's strings.
+ *
+ * */
+struct _VSTD_Interner {
+  struct _VSTD_InternerShard *shards;
+  void *block;
+  usize count;
+  u32 bits;
+  bool locked;
+};
+
+#ifdef VSTD_INTERNER_STRIP_PREFIX
+typedef struct _VSTD_Interner Interner;
+#define _VSTD_Interner Interner
+#else
+typedef struct _VSTD_Interner VSTD_Interner;
+#define _VSTD_Interner VSTD_Interner
+#endif
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_interner_hash
+ *
+ * @description
+ *   _vstd_interner_hash and _vstd_interner_equal are the hash and condition
+ *   functions of the shards' maps. They're helper functions and they're only
+ *   meant to be used the vstd library functions.
+ *
+ * */
+VSTD_STATIC u64 _vstd_interner_hash(const _VSTD_StrView view) {
+  return vstd_hash_bytes(view.ptr, view.len, _vstd_hash_seed);
+}
+
+VSTD_STATIC bool _vstd_interner_equal(const _VSTD_StrView a,
+                                      const _VSTD_StrView b) {
+  return a.len == b.len && memcmp(a.ptr, b.ptr, a.len) == 0;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_interner_new_sharded
+ *
+ * @description
+ *   Creates a new thread safe _VSTD_Interner with the given number of shards,
+ *   rounded up to a power of two. Every function of a thread safe interner
+ *   can be called from any thread.
+ *
+ * @param[in]
+ *   shards : Number of shards.
+ *
+ * @return
+ *   New empty _VSTD_Interner.
+ *
+ * */
+VSTD_STATIC _VSTD_Interner vstd_interner_new_sharded(usize shards) {
+  _VSTD_Interner interner = {.count = 1, .bits = 0, .locked = true};
+  while (interner.count < shards) {
+    interner.count <<= 1;
+    interner.bits++;
+  }
+
+  usize mask = VSTD_INTERNER_ALIGNMENT - 1;
+  interner.block =
+      VSTD_MALLOC(sizeof(struct _VSTD_InternerShard) * interner.count + mask);
+  interner.shards = (struct _VSTD_InternerShard *)(((uptr)interner.block +
+                                                    mask) &
+                                                   ~(uptr)mask);
+  for (usize i = 0; i < interner.count; ++i) {
+    struct _VSTD_InternerShard *shard = &interner.shards[i];
+    pthread_mutex_init(&shard->lock, NULL);
+    shard->arena = vstd_arena_new(0);
+    shard->map = vstd_map_new(_VSTD_StrView, u32, _vstd_interner_hash,
+                              _vstd_interner_equal);
+  }
+
+  return interner;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_interner_new
+ *
+ * @description
+ *   Creates a new _VSTD_Interner with a single shard and no locking, which can
+ *   only be used from one thread at a time.
+ *
+ * @return
+ *   New empty _VSTD_Interner.
+ *
+ * */
+VSTD_STATIC _VSTD_Interner vstd_interner_new(void) {
+  _VSTD_Interner interner = vstd_interner_new_sharded(1);
+  interner.locked = false;
+  return interner;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_interner_shard
+ *
+ * @description
+ *   Returns the shard at the given index, and locks it when the interner is
+ *   thread safe, _vstd_interner_unlock unlocks it. These are helper functions
+ *   and they're only meant to be used the vstd library functions.
+ *
+ * @param[in]
+ *   interner : _VSTD_Interner to access.
+ * @param[in]
+ *   index : Index of the shard.
+ *
+ * @return
+ *   Pointer to the shard.
+ *
+ * */
+VSTD_INLINE struct _VSTD_InternerShard *
+_vstd_interner_shard(_VSTD_Interner *interner, usize index) {
+  struct _VSTD_InternerShard *shard = &interner->shards[index];
+  if (interner->locked) {
+    pthread_mutex_lock(&shard->lock);
+  }
+  return shard;
 }
 
-VSTD_STATIC void vstd_string_free(_VSTD_String *string) {
-  free(string->ptr);
-  string->len = 0;
-  string->cap = 0;
+VSTD_INLINE void _vstd_interner_unlock(_VSTD_Interner *interner,
+                                       struct _VSTD_InternerShard *shard) {
+  if (interner->locked) {
+    pthread_mutex_unlock(&shard->lock);
+  }
 }
 
-VSTD_INLINE void _vstd_string_realloc(_VSTD_String *string) {
-  string->cap *= 2;
-  string->ptr = (char *)realloc(string->ptr, sizeof(char) * string->cap);
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_interner_shard_of
+ *
+ * @description
+ *   Picks the shard of a string from the high bits of its hash, the map of the
+ *   shard uses the low ones, so the same hash is passed to the map of the
+ *   shard. This is a helper function and it's only meant to be used the vstd
+ *   library functions.
+ *
+ * */
+VSTD_INLINE usize _vstd_interner_shard_of(const _VSTD_Interner *interner,
+                                          u64 hash) {
+  if (interner->bits == 0) {
+    return 0;
+  }
+  return (usize)(hash >> (64 - interner->bits));
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_interner_find
+ *
+ * @description
+ *   Looks up a string without interning it.
+ *
+ * @param[in]
+ *   interner : Pointer to _VSTD_Interner to search.
+ * @param[in]
+ *   view : String to look up.
+ * @param[out]
+ *   id : ID of the string, if it's interned.
+ *
+ * @return
+ *   true if the string is interned, false otherwise.
+ *
+ * */
+VSTD_STATIC bool vstd_interner_find(_VSTD_Interner *interner,
+                                    _VSTD_StrView view, u32 *id) {
+  u64 hash = _vstd_interner_hash(view);
+  usize index = _vstd_interner_shard_of(interner, hash);
+  struct _VSTD_InternerShard *shard = _vstd_interner_shard(interner, index);
+
+  bool found;
+  _vstd_map_contains_hashed(_VSTD_StrView, shard->map, view, hash, &found);
+  if (found) {
+    *id = vstd_vector_get(u32, shard->map.vals, shard->map.cache);
+  }
+
+  _vstd_interner_unlock(interner, shard);
+  return found;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_interner_intern
+ *
+ * @description
+ *   Returns the ID of a string, interning it first if it's not interned yet.
+ *   The characters are copied to the shard's arena with a null terminator. IDs
+ *   are assigned in order within a shard, and they have to fit in a u32.
+ *
+ * @param[in]
+ *   interner : Pointer to _VSTD_Interner to modify.
+ * @param[in]
+ *   view : String to intern.
+ *
+ * @return
+ *   ID of the string.
+ *
+ * */
+VSTD_STATIC u32 vstd_interner_intern(_VSTD_Interner *interner,
+                                     _VSTD_StrView view) {
+  u64 hash = _vstd_interner_hash(view);
+  usize index = _vstd_interner_shard_of(interner, hash);
+  struct _VSTD_InternerShard *shard = _vstd_interner_shard(interner, index);
+
+  u32 *id;
+  bool inserted;
+  _vstd_map_entry_hashed(_VSTD_StrView, u32, shard->map, view, hash,
+                         _vstd_map_push_zero(u32, shard->map), id, &inserted);
+  if (inserted) {
+    char *ptr = (char *)vstd_arena_alloc_aligned(&shard->arena, view.len + 1,
+                                                 1);
+    memcpy(ptr, view.ptr, view.len);
+    ptr[view.len] = '\0';
+    vstd_vector_set(_VSTD_StrView, (&shard->map.keys), shard->map.cache,
+                    vstd_strview_new(ptr, view.len));
+    *id = (u32)((usize)shard->map.cache << interner->bits | index);
+  }
+
+  u32 result = *id;
+  _vstd_interner_unlock(interner, shard);
+  return result;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_interner_intern_str
+ *
+ * @description
+ *   Same as vstd_interner_intern, but for null terminated strings.
+ *
+ * @param[in]
+ *   interner : Pointer to _VSTD_Interner to modify.
+ * @param[in]
+ *   str : String to intern.
+ *
+ * @return
+ *   ID of the string.
+ *
+ * */
+VSTD_INLINE u32 vstd_interner_intern_str(_VSTD_Interner *interner,
+                                         const char *str) {
+  return vstd_interner_intern(interner, vstd_strview_from(str));
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_interner_get
+ *
+ * @description
+ *   Returns the string of an ID returned by the interner. The view points to
+ *   the interned, null terminated characters, which stay valid until the
+ *   interner is freed.
+ *
+ * @param[in]
+ *   interner : Pointer to _VSTD_Interner to access.
+ * @param[in]
+ *   id : ID of the string.
+ *
+ * @return
+ *   _VSTD_StrView of the string.
+ *
+ * */
+VSTD_STATIC _VSTD_StrView vstd_interner_get(_VSTD_Interner *interner,
+                                            u32 id) {
+  usize index = id & (interner->count - 1);
+  struct _VSTD_InternerShard *shard = _vstd_interner_shard(interner, index);
+  _VSTD_StrView view =
+      vstd_vector_get(_VSTD_StrView, shard->map.keys, id >> interner->bits);
+  _vstd_interner_unlock(interner, shard);
+  return view;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_interner_len
+ *
+ * @description
+ *   Returns the number of interned strings.
+ *
+ * @param[in]
+ *   interner : Pointer to _VSTD_Interner to access.
+ *
+ * @return
+ *   Number of interned strings.
+ *
+ * */
+VSTD_STATIC usize vstd_interner_len(_VSTD_Interner *interner) {
+  usize len = 0;
+  for (usize i = 0; i < interner->count; ++i) {
+    struct _VSTD_InternerShard *shard = _vstd_interner_shard(interner, i);
+    len += shard->map.keys.len;
+    _vstd_interner_unlock(interner, shard);
+  }
+  return len;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   vstd_interner_free
+ *
+ * @description
+ *   Frees the interner and every interned string.
+ *
+ * @param[in]
+ *   interner : Pointer to _VSTD_Interner to free.
+ *
+ * */
+VSTD_STATIC void vstd_interner_free(_VSTD_Interner *interner) {
+  for (usize i = 0; i < interner->count; ++i) {
+    struct _VSTD_InternerShard *shard = &interner->shards[i];
+    vstd_map_free(_VSTD_StrView, u32, shard->map);
+    vstd_arena_free_all(&shard->arena);
+    pthread_mutex_destroy(&shard->lock);
+  }
+  VSTD_FREE(interner->block);
+  interner->shards = NULL;
+  interner->block = NULL;
+  interner->count = 0;
+}
+
+/*****************************************************************************
+ *
+ * @section
+ *   VSTD Static
+ *
+ * @description
+ *   Fixed capacity containers, which never allocate. Their storage is a part
+ *   of the struct itself, so they live entirely on the stack or in static
+ *   storage, and can be used where calling malloc is not allowed. Instead of
+ *   growing, every operation that would exceed the capacity reports it and
+ *   leaves the container unchanged.
+ *
+ * */
+
+#ifdef VSTD_STATIC_STRIP_PREFIX
+#define StaticVector(T, N) VSTD_StaticVector(T, N)
+#define StaticString(N) VSTD_StaticString(N)
+#define StaticMap(K, V, N) VSTD_StaticMap(K, V, N)
+#endif
+
+/*****************************************************************************
+ *
+ * @type:
+ *   VSTD_StaticVector
+ *
+ * @description:
+ *   Vector holding up to N items of type T. It has the same ptr and len fields
+ *   as _VSTD_Vector, so vstd_vector_get and vstd_vector_iter work on it too.
+ *
+ * */
+#define VSTD_StaticVector(T, N)                                                \
+  struct {                                                                     \
+    usize len;                                                                 \
+    T ptr[N];                                                                  \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_vector_new
+ *
+ * @description
+ *   Initializer of an empty VSTD_StaticVector.
+ *
+ * */
+#define vstd_static_vector_new()                                               \
+  { .len = 0 }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_vector_cap
+ *
+ * @description
+ *   Returns the capacity of the VSTD_StaticVector.
+ *
+ * @param[in]
+ *   vec : Pointer to the VSTD_StaticVector.
+ *
+ * */
+#define vstd_static_vector_cap(vec) (sizeof((vec)->ptr) / sizeof((vec)->ptr[0]))
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_vector_push
+ *
+ * @description
+ *   Pushes a new item to the end of the given VSTD_StaticVector, if it's not
+ *   full.
+ *
+ * @param[in]
+ *   vec : Pointer to the VSTD_StaticVector to modify.
+ * @param[in]
+ *   item : Item to add.
+ *
+ * @return
+ *   True if the item is added, false if the vector is full.
+ *
+ * */
+#define vstd_static_vector_push(vec, item)                                     \
+  ((vec)->len < vstd_static_vector_cap(vec)                                    \
+       ? ((vec)->ptr[(vec)->len++] = (item), true)                             \
+       : false)
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_static_push_n
+ *
+ * @description
+ *   Copies count items of the given size to the end of a fixed capacity
+ *   array, if they fit. This is a helper function and it's only meant to be
+ *   used the vstd library functions.
+ *
+ * @return
+ *   True if the items are added, false if they don't fit.
+ *
+ * */
+VSTD_STATIC bool _vstd_static_push_n(void *ptr, usize *len, usize cap,
+                                     usize size, const void *items,
+                                     usize count) {
+  if (count > cap - *len) {
+    return false;
+  }
+  memcpy((u8 *)ptr + *len * size, items, count * size);
+  *len += count;
+  return true;
 }
 
 /*****************************************************************************
  *
- * @section
- *   VSTD Vector
+ * @macro
+ *   vstd_static_vector_push_n
+ *
+ * @description
+ *   Pushes count items to the end of the given VSTD_StaticVector, if all of
+ *   them fit.
+ *
+ * @param[in]
+ *   vec : Pointer to the VSTD_StaticVector to modify.
+ * @param[in]
+ *   items : Pointer to the items to add.
+ * @param[in]
+ *   count : Number of items to add.
+ *
+ * @return
+ *   True if the items are added, false if they don't fit.
+ *
+ * */
+#define vstd_static_vector_push_n(vec, items, count)                           \
+  _vstd_static_push_n((vec)->ptr, &(vec)->len, vstd_static_vector_cap(vec),    \
+                      sizeof((vec)->ptr[0]), items, count)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_vector_pop
+ *
+ * @description
+ *   Removes the last item of the given non-empty VSTD_StaticVector.
+ *
+ * @param[in]
+ *   vec : Pointer to the VSTD_StaticVector to modify.
+ *
+ * @return
+ *   The removed item.
+ *
+ * */
+#define vstd_static_vector_pop(vec) ((vec)->ptr[--(vec)->len])
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_vector_remove
+ *
+ * @description
+ *   Removes the item at the given index from VSTD_StaticVector, remaining
+ *   items are shifted to left.
+ *
+ * @param[in]
+ *   vec : Pointer to the VSTD_StaticVector to modify.
+ * @param[in]
+ *   index : Index to remove.
+ *
+ * */
+#define vstd_static_vector_remove(vec, index)                                  \
+  do {                                                                         \
+    usize _index = (index);                                                    \
+    memmove((vec)->ptr + _index, (vec)->ptr + _index + 1,                      \
+            sizeof((vec)->ptr[0]) * ((vec)->len - _index - 1));                \
+    (vec)->len--;                                                              \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_vector_swap_remove
+ *
+ * @description
+ *   Removes the item at the given index from VSTD_StaticVector in O(1), by
+ *   moving the last item into its place.
+ *
+ * @param[in]
+ *   vec : Pointer to the VSTD_StaticVector to modify.
+ * @param[in]
+ *   index : Index to remove.
+ *
+ * */
+#define vstd_static_vector_swap_remove(vec, index)                             \
+  do {                                                                         \
+    usize _index = (index);                                                    \
+    (vec)->ptr[_index] = (vec)->ptr[--(vec)->len];                             \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_vector_clear
+ *
+ * @description
+ *   Sets the length of the VSTD_StaticVector to zero.
+ *
+ * @param[in]
+ *   vec : Pointer to the VSTD_StaticVector to modify.
+ *
+ * */
+#define vstd_static_vector_clear(vec)                                          \
+  do {                                                                         \
+    (vec)->len = 0;                                                            \
+  } while (0)
+
+/*****************************************************************************
+ *
+ * @type:
+ *   VSTD_StaticString
+ *
+ * @description:
+ *   String holding up to N characters, which is always null terminated.
+ *
+ * */
+#define VSTD_StaticString(N)                                                   \
+  struct {                                                                     \
+    usize len;                                                                 \
+    char buf[(N) + 1];                                                         \
+  }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_string_new
+ *
+ * @description
+ *   Initializer of an empty VSTD_StaticString.
+ *
+ * */
+#define vstd_static_string_new()                                               \
+  { .len = 0 }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_string_cap
+ *
+ * @description
+ *   Returns the capacity of the VSTD_StaticString, not counting the null
+ *   terminator.
+ *
+ * @param[in]
+ *   string : Pointer to the VSTD_StaticString.
+ *
+ * */
+#define vstd_static_string_cap(string) (sizeof((string)->buf) - 1)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_string_view
+ *
+ * @description
+ *   Returns a _VSTD_StrView of the VSTD_StaticString's contents.
+ *
+ * @param[in]
+ *   string : Pointer to the VSTD_StaticString.
  *
  * */
+#define vstd_static_string_view(string)                                        \
+  vstd_strview_new((string)->buf, (string)->len)
 
 /*****************************************************************************
  *
- * @type:
- *   _VSTD_Vector
+ * @function
+ *   _vstd_static_string_push_n
  *
- * @description:
- *   Vector implementation, this struct never allocates memory for itself, but
- *   only for its underlying pointer. When passing an instance of this type its
- *   safe to pass it as it is to a function, as long as that function doesn't
- *   modify the vector's pointer or other properties. Otherwise you should pass
- *   it as a reference, or you may lose the underlying pointer.
+ * @description
+ *   Appends n characters to a fixed capacity string if they fit, and keeps it
+ *   null terminated. This is a helper function and it's only meant to be used
+ *   the vstd library functions.
+ *
+ * @return
+ *   True if the characters are added, false if they don't fit.
  *
  * */
-struct _VSTD_Vector {
-  void *ptr;
-  usize len;
-  usize cap;
-};
+VSTD_STATIC bool _vstd_static_string_push_n(char *buf, usize *len, usize cap,
+                                            const char *str, usize n) {
+  if (n > cap - *len) {
+    return false;
+  }
+  memcpy(buf + *len, str, sizeof(char) * n);
+  *len += n;
+  buf[*len] = '\0';
+  return true;
+}
 
-#ifdef VSTD_VECTOR_STRIP_PREFIX
-#define Vector(type) struct _VSTD_Vector
-#else
-#define VSTD_Vector(type) struct _VSTD_Vector
-#endif
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_static_string_format
+ *
+ * @description
+ *   Replaces the contents of a fixed capacity string with formatted output if
+ *   it fits, otherwise the string is cleared. This is a helper function and
+ *   it's only meant to be used the vstd library functions.
+ *
+ * @return
+ *   True if the output fits, false otherwise.
+ *
+ * */
+VSTD_STATIC bool _vstd_static_string_format(char *buf, usize *len, usize cap,
+                                            const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(buf, cap + 1, fmt, args);
+  va_end(args);
 
-#ifndef VSTD_VECTOR_INITIAL_CAP
-#define VSTD_VECTOR_INITIAL_CAP 1
-#endif
+  if (n < 0 || (usize)n > cap) {
+    *len = 0;
+    buf[0] = '\0';
+    return false;
+  }
+  *len = (usize)n;
+  return true;
+}
 
 /*****************************************************************************
  *
  * @macro
- *   vstd_vector_new
+ *   vstd_static_string_push
  *
  * @description
- *   Creates a new empty _VSTD_Vector object, this macro internally just calls
- *   vstd_vector_with_capacity with VSTD_VECTOR_INITIAL_CAP as the argument.
+ *   Pushes a character to the end of the given VSTD_StaticString.
  *
  * @param[in]
- *   type : Type of the _VSTD_Vector's data.
+ *   string : Pointer to the VSTD_StaticString to modify.
+ * @param[in]
+ *   c : Character to add.
  *
  * @return
- *   New empty _VSTD_Vector with capacity of VSTD_VECTOR_INITIAL_CAP.
+ *   True if the character is added, false if the string is full.
  *
  * */
-#define vstd_vector_new(type)                                                  \
-  vstd_vector_with_capacity(type, VSTD_VECTOR_INITIAL_CAP)
+#define vstd_static_string_push(string, c)                                     \
+  _vstd_static_string_push_n((string)->buf, &(string)->len,                    \
+                             vstd_static_string_cap(string), &(char){c}, 1)
 
 /*****************************************************************************
  *
  * @macro
- *   vstd_vector_with_capacity
+ *   vstd_static_string_push_str
  *
  * @description
- *   Creates a new empty _VSTD_Vector object with the given capacity.
+ *   Pushes a C string to the end of the given VSTD_StaticString, if all of it
+ *   fits.
  *
  * @param[in]
- *   type : Type of the _VSTD_Vector's data.
+ *   string : Pointer to the VSTD_StaticString to modify.
  * @param[in]
- *   capacity : Capacity of the new _VSTD_Vector.
+ *   str : C string to add.
  *
  * @return
- *   New empty _VSTD_Vector with given capacity.
+ *   True if the C string is added, false if it doesn't fit.
  *
  * */
-#define vstd_vector_with_capacity(type, capacity)                              \
-  (struct _VSTD_Vector) {                                                      \
-    .ptr = malloc(sizeof(type) * capacity), .cap = capacity, .len = 0          \
-  }
+#define vstd_static_string_push_str(string, str)                               \
+  vstd_static_string_push_view(string, vstd_strview_from(str))
 
 /*****************************************************************************
  *
  * @macro
- *   vstd_vector_from
+ *   vstd_static_string_push_view
  *
  * @description
- *   Creates a new _VSTD_Vector containing the data in the initializer list.
- *   Data is first assigned to a temporary variable then copied to the var.
- *   Returns a non-allocated _VSTD_Vector to allow single line initializations.
+ *   Pushes the contents of a _VSTD_StrView to the end of the given
+ *   VSTD_StaticString, if all of it fits.
  *
  * @param[in]
- *   type : Type of the _VSTD_Vector's data.
- * @param[out]
- *   var : Variable to assign the vector.
+ *   string : Pointer to the VSTD_StaticString to modify.
  * @param[in]
- *   ... : Initializer list
+ *   view : _VSTD_StrView to add.
  *
  * @return
- *   New non-allocated _VSTD_Vector.
+ *   True if the view is added, false if it doesn't fit.
  *
  * */
-#define vstd_vector_from(type, var, ...)                                       \
-  (struct _VSTD_Vector){};                                                     \
-  do {                                                                         \
-    type temp[] = __VA_ARGS__;                                                 \
-    var.ptr = malloc(sizeof(temp));                                            \
-    memcpy(var.ptr, temp, sizeof(temp));                                       \
-    var.cap = sizeof(temp) / sizeof(type);                                     \
-    var.len = var.cap;                                                         \
-  } while (0)
+#define vstd_static_string_push_view(string, view)                             \
+  _vstd_static_string_push_n((string)->buf, &(string)->len,                    \
+                             vstd_static_string_cap(string), (view).ptr,       \
+                             (view).len)
 
 /*****************************************************************************
  *
  * @macro
- *   vstd_vector_clone
+ *   vstd_static_string_format
  *
  * @description
- *   Clones the given _VSTD_Vector and assigns the clone to var. Returns a
- *   non-allocated _VSTD_Vector to allow single line initializations.
+ *   Replaces the contents of the VSTD_StaticString with formatted output. If
+ *   the output doesn't fit, the string is cleared. vsnprintf is not async
+ *   signal safe, so this macro shouldn't be used in signal handlers.
  *
  * @param[in]
- *   type : Type of the _VSTD_Vector's data.
- * @param[out]
- *   var : Variable to assign the clone.
+ *   string : Pointer to the VSTD_StaticString to modify.
  * @param[in]
- *   other : _VSTD_Vector to clone.
+ *   ... : Format string and its arguments.
  *
  * @return
- *   New non-allocated _VSTD_Vector.
+ *   True if the output fits, false otherwise.
  *
  * */
-#define vstd_vector_clone(type, var, other)                                    \
-  (struct _VSTD_Vector){};                                                     \
+#define vstd_static_string_format(string, ...)                                 \
+  _vstd_static_string_format((string)->buf, &(string)->len,                    \
+                             vstd_static_string_cap(string), __VA_ARGS__)
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_string_clear
+ *
+ * @description
+ *   Sets the length of the VSTD_StaticString to zero.
+ *
+ * @param[in]
+ *   string : Pointer to the VSTD_StaticString to modify.
+ *
+ * */
+#define vstd_static_string_clear(string)                                       \
   do {                                                                         \
-    var.ptr = malloc(sizeof(type) * other.cap);                                \
-    memcpy(var.ptr, other.ptr, sizeof(type) * other.len);                      \
-    var.cap = other.cap;                                                       \
-    var.len = other.len;                                                       \
+    (string)->len = 0;                                                         \
+    (string)->buf[0] = '\0';                                                   \
   } while (0)
 
+/*****************************************************************************
+ *
+ * @type:
+ *   VSTD_StaticMap
+ *
+ * @description:
+ *   Map holding up to N keys and values, stored in insertion order like in
+ *   _VSTD_Map, with their hashes. The hash table has 2 * N slots storing the
+ *   index of an entry plus one, or zero when the slot is empty, and it's
+ *   probed linearly, so it's never more than half full.
+ *
+ * */
+#define VSTD_StaticMap(K, V, N)                                                \
+  struct {                                                                     \
+    usize len;                                                                 \
+    u64 (*hash)(K);                                                            \
+    bool (*func)(K, K);                                                        \
+    K keys[N];                                                                 \
+    V vals[N];                                                                 \
+    u64 hashes[N];                                                             \
+    u32 slots[2 * (N)];                                                        \
+  }
+
 /*****************************************************************************
  *
  * @macro
- *   vstd_vector_get
+ *   vstd_static_map_new
  *
  * @description
- *   Returns the item at the given index. This is the intended way to access an
- *   element from _VSTD_Vector since _VSTD_Vector needs to be casted to desired
- *   type first.
+ *   Initializer of an empty VSTD_StaticMap.
  *
  * @param[in]
- *   type : Type of the _VSTD_Vector's data.
+ *   hash_fn : Hash function that will be used to hash keys.
  * @param[in]
- *   vec : _VSTD_Vector to retrieve the item from.
+ *   condition : Condition function that will be used to compare keys.
+ *
+ * */
+#define vstd_static_map_new(hash_fn, condition)                                \
+  { .len = 0, .hash = hash_fn, .func = condition }
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_map_cap
+ *
+ * @description
+ *   Returns the capacity of the VSTD_StaticMap.
+ *
  * @param[in]
- *   index : Index of the item.
+ *   map : VSTD_StaticMap to access.
  *
- * @return
- *   Item at given index.
+ * */
+#define vstd_static_map_cap(map) (sizeof((map).keys) / sizeof((map).keys[0]))
+
+/*****************************************************************************
+ *
+ * @macro
+ *   _vstd_static_map_find
+ *
+ * @description
+ *   Probes the hash table for the key. index is set to the index of the key,
+ *   or -1, and slot to the slot pointing to it, or to the empty slot where it
+ *   would be inserted. This is a helper macro and it's only meant to be used
+ *   the vstd library functions.
  *
  * */
-#define vstd_vector_get(type, vec, index) ((type *)vec.ptr)[index]
+#define _vstd_static_map_find(map, key, hash, index, slot)                     \
+  do {                                                                         \
+    usize _slots = sizeof((map).slots) / sizeof((map).slots[0]);               \
+    index = -1;                                                                \
+    slot = (usize)(hash % _slots);                                             \
+    for (; (map).slots[slot]; slot = slot + 1 == _slots ? 0 : slot + 1) {      \
+      usize _entry = (map).slots[slot] - 1;                                    \
+      if ((map).hashes[_entry] == hash &&                                      \
+          (map).func((map).keys[_entry], key)) {                               \
+        index = (iptr)_entry;                                                  \
+        break;                                                                 \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
 
 /*****************************************************************************
  *
  * @macro
- *   vstd_vector_set
+ *   vstd_static_map_contains
  *
  * @description
- *   Replaces the item at the given index with the item. This macro doesn't
- *   modify the _VSTD_Vector but only the item at given index.
+ *   Checks if the given VSTD_StaticMap contains the key.
  *
  * @param[in]
- *   type : Type of the _VSTD_Vector's data.
- * @param[in]
- *   vec : Pointer to _VSTD_Vector to modify.
- * @param[in]
- *   index : Target index to replace.
+ *   map : VSTD_StaticMap to search.
  * @param[in]
- *   item : Item to replace with.
+ *   key : Key to search for.
+ * @param[out]
+ *   result : Pointer to the bool to store the result.
  *
  * */
-#define vstd_vector_set(type, vec, index, item)                                \
+#define vstd_static_map_contains(map, key, result)                             \
   do {                                                                         \
-    ((type *)vec->ptr)[index] = item;                                          \
+    __typeof__((map).keys[0]) _key = (key);                                    \
+    u64 _hash = (map).hash(_key);                                              \
+    iptr _index;                                                               \
+    usize _slot;                                                               \
+    _vstd_static_map_find(map, _key, _hash, _index, _slot);                    \
+    *(result) = _index >= 0;                                                   \
   } while (0)
 
 /*****************************************************************************
  *
  * @macro
- *   vstd_vector_push
+ *   vstd_static_map_get
  *
  * @description
- *   Pushes a new item to the end of the given _VSTD_Vector. This macro may
- *   resize the _VSTD_Vector.
+ *   Tries to retrieve a value from the given VSTD_StaticMap. If successful a
+ *   pointer to value is assigned to out, if not out is set to NULL.
  *
  * @param[in]
- *   type : Type of the _VSTD_Vector's data.
- * @param[in]
- *   vec : Pointer to _VSTD_Vector to modify.
+ *   map : VSTD_StaticMap to get the value from.
  * @param[in]
- *   item : Item to add.
+ *   key : Key to access.
+ * @param[out]
+ *   out : Variable to store the pointer to the value.
  *
  * */
-#define vstd_vector_push(type, vec, item)                                      \
+#define vstd_static_map_get(map, key, out)                                     \
   do {                                                                         \
-    if (vec->len + 1 >= vec->cap) {                                            \
-      vec->cap *= 2;                                                           \
-      vec->ptr = realloc(vec->ptr, vec->cap * sizeof(type));                   \
-    }                                                                          \
-    vstd_vector_set(type, vec, vec->len, item);                                \
-    vec->len++;                                                                \
+    __typeof__((map).keys[0]) _key = (key);                                    \
+    u64 _hash = (map).hash(_key);                                              \
+    iptr _index;                                                               \
+    usize _slot;                                                               \
+    _vstd_static_map_find(map, _key, _hash, _index, _slot);                    \
+    out = _index >= 0 ? &(map).vals[_index] : NULL;                            \
   } while (0)
 
 /*****************************************************************************
  *
  * @macro
- *   vstd_vector_remove
+ *   vstd_static_map_set
  *
  * @description
- *   Removes the item at the given index from _VSTD_Vector. If item is not at
- *   the end of the _VSTD_Vector, remaining items are shifted to left.
+ *   Sets the value of the key in the given VSTD_StaticMap. If the key doesn't
+ *   exist and the map is full, the map is left unchanged.
  *
  * @param[in]
- *   type : Type of the _VSTD_Vector's data.
+ *   map : VSTD_StaticMap to modify.
  * @param[in]
- *   vec : Pointer to _VSTD_Vector to modify.
+ *   key : Key to set.
  * @param[in]
- *   index : Index to remove.
+ *   value : Value to set.
+ * @param[out]
+ *   result : Pointer to the bool to store if the value is set.
  *
  * */
-#define vstd_vector_remove(type, vec, index)                                   \
+#define vstd_static_map_set(map, key, value, result)                           \
   do {                                                                         \
-    if (index != ((isize)vec->len - 1)) {                                      \
-      type *ptr = ((type *)vec->ptr) + index;                                  \
-      memmove(ptr, ptr + 1, (vec->len - (index + 1)) * sizeof(type));          \
+    __typeof__((map).keys[0]) _key = (key);                                    \
+    u64 _hash = (map).hash(_key);                                              \
+    iptr _index;                                                               \
+    usize _slot;                                                               \
+    _vstd_static_map_find(map, _key, _hash, _index, _slot);                    \
+    *(result) = true;                                                          \
+    if (_index >= 0) {                                                         \
+      (map).vals[_index] = (value);                                            \
+    } else if ((map).len < vstd_static_map_cap(map)) {                         \
+      (map).keys[(map).len] = _key;                                            \
+      (map).vals[(map).len] = (value);                                         \
+      (map).hashes[(map).len] = _hash;                                         \
+      (map).slots[_slot] = (u32)++(map).len;                                   \
+    } else {                                                                   \
+      *(result) = false;                                                       \
     }                                                                          \
-    vec->len--;                                                                \
   } while (0)
 
 /*****************************************************************************
  *
- * @macro
- *   vstd_vector_iter
+ * @function
+ *   _vstd_static_map_erase_slot
  *
  * @description
- *   Helper function to easily iterate trough the length of the _VSTD_Vector.
- *   In every iteration it is possible to access the current item from _$iter
- *   and current index from _$i.
+ *   Empties a slot of a linearly probed hash table, moving the following
+ *   entries of the cluster back so every entry stays reachable from its home
+ *   slot. This is a helper function and it's only meant to be used the vstd
+ *   library functions.
  *
  * @param[in]
- *   type : Type of the _VSTD_Vector's data.
+ *   slots : Slots of the hash table.
  * @param[in]
- *   vec : _VSTD_Vector to iterate.
+ *   count : Number of slots.
  * @param[in]
- *   ... : A single function or a block of code to execute every iteration.
+ *   hashes : Hashes of the entries.
+ * @param[in]
+ *   slot : Slot to empty.
  *
  * */
-#define vstd_vector_iter(type, vec, ...)                                       \
+VSTD_STATIC void _vstd_static_map_erase_slot(u32 *slots, usize count,
+                                             const u64 *hashes, usize slot) {
+  usize hole = slot;
+  for (usize next = hole + 1 == count ? 0 : hole + 1; slots[next];
+       next = next + 1 == count ? 0 : next + 1) {
+    usize home = (usize)(hashes[slots[next] - 1] % count);
+    bool movable = hole <= next ? (home <= hole || home > next)
+                                : (home <= hole && home > next);
+    if (movable) {
+      slots[hole] = slots[next];
+      hole = next;
+    }
+  }
+  slots[hole] = 0;
+}
+
+/*****************************************************************************
+ *
+ * @function
+ *   _vstd_static_map_move_index
+ *
+ * @description
+ *   Points the slot storing the from index to the to index instead. This is a
+ *   helper function and it's only meant to be used the vstd library
+ *   functions.
+ *
+ * */
+VSTD_STATIC void _vstd_static_map_move_index(u32 *slots, usize count,
+                                             u64 hash, usize from, usize to) {
+  for (usize slot = (usize)(hash % count); slots[slot];
+       slot = slot + 1 == count ? 0 : slot + 1) {
+    if (slots[slot] == from + 1) {
+      slots[slot] = (u32)(to + 1);
+      return;
+    }
+  }
+}
+
+/*****************************************************************************
+ *
+ * @macro
+ *   vstd_static_map_remove
+ *
+ * @description
+ *   Tries to remove the key and its associated value from the given
+ *   VSTD_StaticMap. The last key and value are moved into the place of the
+ *   removed ones, so the insertion order is not preserved.
+ *
+ * @param[in]
+ *   map : VSTD_StaticMap to remove the key from.
+ * @param[in]
+ *   key : Key to remove.
+ *
+ * */
+#define vstd_static_map_remove(map, key)                                       \
   do {                                                                         \
-    for (type *_$iter = vec.ptr; _$iter < ((type *)vec.ptr) + vec.len;         \
-         ++_$iter) {                                                           \
-      usize _$i = ((void *)_$iter - vec.ptr) / sizeof(type);                   \
-      __VA_ARGS__;                                                             \
-      (void)(_$i);                                                             \
-      (void)(_$iter);                                                          \
+    __typeof__((map).keys[0]) _key = (key);                                    \
+    u64 _hash = (map).hash(_key);                                              \
+    iptr _index;                                                               \
+    usize _slot;                                                               \
+    _vstd_static_map_find(map, _key, _hash, _index, _slot);                    \
+    if (_index >= 0) {                                                         \
+      usize _count = sizeof((map).slots) / sizeof((map).slots[0]);             \
+      usize _last = --(map).len;                                               \
+      _vstd_static_map_erase_slot((map).slots, _count, (map).hashes, _slot);   \
+      if ((usize)_index != _last) {                                            \
+        _vstd_static_map_move_index((map).slots, _count,                       \
+                                    (map).hashes[_last], _last, _index);       \
+        (map).keys[_index] = (map).keys[_last];                                \
+        (map).vals[_index] = (map).vals[_last];                                \
+        (map).hashes[_index] = (map).hashes[_last];                            \
+      }                                                                        \
     }                                                                          \
   } while (0)
 
 /*****************************************************************************
  *
  * @macro
- *   vstd_vector_clear
+ *   vstd_static_map_clear
  *
  * @description
- *   Set's given _VSTD_Vector's length to 0, basically soft resetting it. This
- *   doesn't actually modify or free the underlying pointer.
+ *   Removes every key and value from the VSTD_StaticMap.
  *
  * @param[in]
- *   type : Type of the _VSTD_Vector's data.
- * @param[in]
- *   vec : Pointer to _VSTD_Vector to clear.
+ *   map : VSTD_StaticMap to clear.
  *
  * */
-#define vstd_vector_clear(type, vec)                                           \
+#define vstd_static_map_clear(map)                                             \
   do {                                                                         \
-    vec->len = 0;                                                              \
+    (map).len = 0;                                                             \
+    memset((map).slots, 0, sizeof((map).slots));                               \
   } while (0)
 
 /*****************************************************************************
  *
  * @macro
- *   vstd_vector_free
+ *   vstd_static_map_iter
  *
  * @description
- *   Frees the underlying pointer of the given _VSTD_Vector.
+ *   Helper function to easily iterate trough the all the keys and values stored
+ *   in a VSTD_StaticMap. In every iteration it is possible to access the
+ *   current key and value from _$iter and current index from _$i.
  *
  * @param[in]
- *   type : Type of the _VSTD_Vector's data.
+ *   map : VSTD_StaticMap to iterate.
  * @param[in]
- *   vec : Pointer to _VSTD_Vector to free.
+ *   ... : A single function or a block of code to execute every iteration.
  *
  * */
-#define vstd_vector_free(type, vec)                                            \
+#define vstd_static_map_iter(map, ...)                                         \
   do {                                                                         \
-    free(vec->ptr);                                                            \
-    vec->ptr = NULL;                                                           \
-    vec->cap = 0;                                                              \
-    vec->len = 0;                                                              \
+    struct {                                                                   \
+      __typeof__(&(map).keys[0]) key;                                          \
+      __typeof__(&(map).vals[0]) val;                                          \
+    } _$iter;                                                                  \
+    for (usize _$i = 0; _$i < (map).len; ++_$i) {                              \
+      _$iter.key = &(map).keys[_$i];                                           \
+      _$iter.val = &(map).vals[_$i];                                           \
+      __VA_ARGS__;                                                             \
+      (void)(_$i);                                                             \
+      (void)(_$iter);                                                          \
+    }                                                                          \
   } while (0)
 
 /*****************************************************************************
  *
- * @section
- *   VSTD Map
+ * @section
+ *   VSTD Matcher
+ *
+ * @description
+ *   Multi-pattern search using the Aho-Corasick automaton. Patterns are
+ *   compiled once into a DFA over byte classes, after which every occurrence
+ *   of every pattern is found in a single linear pass over the input.
+ *
+ * */
+
+/*****************************************************************************
+ *
+ * @type:
+ *   _VSTD_Matcher
+ *
+ * @description:
+ *   Compiled multi-pattern matcher. Bytes that appear in the patterns are
+ *   mapped to their own class, and every other byte is mapped to class 0, so
+ *   the transition table only has a column per distinct pattern byte. If the
+ *   patterns use all 256 bytes, class 0 holds the last one. Every state stores
+ *   the id of the longest pattern ending at it, and a link to the next state on
+ *   its fail chain that has an output. Identical patterns are chained from the
+ *   first one's id by same, and depth holds the length of every state.
  *
  * */
+struct _VSTD_Matcher {
+  u8 classes[256];
+  usize class_count;
+  usize min_len;
+  struct _VSTD_Vector next;
+  struct _VSTD_Vector out;
+  struct _VSTD_Vector link;
+  struct _VSTD_Vector lens;
+  struct _VSTD_Vector same;
+  struct _VSTD_Vector depth;
+};
+
+#ifdef VSTD_MATCHER_STRIP_PREFIX
+typedef struct _VSTD_Matcher Matcher;
+#define _VSTD_Matcher Matcher
+#else
+typedef struct _VSTD_Matcher VSTD_Matcher;
+#define _VSTD_Matcher VSTD_Matcher
+#endif
 
 /*****************************************************************************
  *
- * @type
- *   _VSTD_Map
+ * @type:
+ *   _VSTD_Match
  *
- * @description
- *   Map implementation, this type doesn't allocate any memory for itself, but
- *   its underlying _VSTD_Vector's allocate memory for their pointers. Thus,
- *   it's safe to pass this type to functions as it is, as long as said function
- *   doesn't alter any of the properties of _VSTD_Map or its _VSTD_Vector's.
- *   Otherwise it should be passed as a reference or may result in the lose of
- *   the underlying pointers.
+ * @description:
+ *   Single match reported by a _VSTD_Matcher, id is the index of the pattern
+ *   in the _VSTD_Vector the matcher was built from.
  *
  * */
-struct _VSTD_Map {
-  struct _VSTD_Vector keys;
-  struct _VSTD_Vector vals;
-  void *func_ptr;
-  iptr cache;
+struct _VSTD_Match {
+  usize id;
+  usize offset;
+  usize len;
 };
 
-#ifdef VSTD_MAP_STRIP_PREFIX
-#define Map(k, v) struct _VSTD_Map
+#ifdef VSTD_MATCHER_STRIP_PREFIX
+typedef struct _VSTD_Match Match;
+#define _VSTD_Match Match
 #else
-#define VSTD_Map(k, v) struct _VSTD_Map
+typedef struct _VSTD_Match VSTD_Match;
+#define _VSTD_Match VSTD_Match
 #endif
 
 /*****************************************************************************
  *
- * @macro
- *   vstd_map_new
+ * @function
+ *   vstd_matcher_new
  *
  * @description
- *   Creates a new empty _VSTD_Map.
+ *   Compiles the patterns into a new _VSTD_Matcher. Empty patterns are ignored,
+ *   and a repeated pattern reports every index it appears at.
  *
  * @param[in]
- *   k : Type of the keys stored in _VSTD_Map.
- * @param[in]
- *   v : Type of the values stored in _VSTD_Map.
- * @param[in]
- *   condition : Condition function that will be used to compare keys.
+ *   patterns : Pointer to a _VSTD_Vector of _VSTD_Strings to search for.
  *
  * @return
- *   New empty _VSTD_Map.
+ *   New _VSTD_Matcher.
  *
  * */
-#define vstd_map_new(k, v, condition)                                          \
-  (struct _VSTD_Map) {                                                         \
-    .keys = vstd_vector_new(k), .vals = vstd_vector_new(v),                    \
-    .func_ptr = condition, .cache = -1,                                        \
+VSTD_STATIC _VSTD_Matcher
+vstd_matcher_new(const struct _VSTD_Vector *patterns) {
+  _VSTD_Matcher m = (_VSTD_Matcher){
+      .class_count = 1,
+      .min_len = 0,
+      .next = vstd_vector_new(u32),
+      .out = vstd_vector_new(u32),
+      .link = vstd_vector_new(u32),
+      .lens = vstd_vector_with_capacity(usize, patterns->len + 1),
+      .same = vstd_vector_with_capacity(u32, patterns->len + 1),
+      .depth = vstd_vector_new(u32),
+  };
+  memset(m.classes, 0, sizeof(m.classes));
+
+  vstd_vector_iter(_VSTD_String, (*patterns), {
+    const u8 *ptr = (const u8 *)vstd_string_ptr(_$iter);
+    for (usize i = 0; i < vstd_string_len(_$iter); ++i) {
+      if (!m.classes[ptr[i]] && m.class_count < 256) {
+        m.classes[ptr[i]] = (u8)m.class_count++;
+      }
+    }
+  });
+  /* When the patterns use every byte, the last new byte is left in class 0,
+   * which no other byte is in, so there are never more than 256 classes. */
+
+  /* Build the trie, a transition to the root means there is no edge yet. */
+  usize c = m.class_count;
+  for (usize i = 0; i < c; ++i) {
+    vstd_vector_push(u32, (&m.next), 0);
+  }
+  vstd_vector_push(u32, (&m.out), 0);
+  vstd_vector_push(u32, (&m.link), 0);
+  vstd_vector_push(u32, (&m.depth), 0);
+
+  vstd_vector_iter(_VSTD_String, (*patterns), {
+    const u8 *ptr = (const u8 *)vstd_string_ptr(_$iter);
+    usize len = vstd_string_len(_$iter);
+    vstd_vector_push(usize, (&m.lens), len);
+    vstd_vector_push(u32, (&m.same), 0);
+    if (!len) {
+      continue;
+    }
+    if (!m.min_len || len < m.min_len) {
+      m.min_len = len;
+    }
+
+    u32 state = 0;
+    for (usize i = 0; i < len; ++i) {
+      u32 *edge = (u32 *)m.next.ptr + state * c + m.classes[ptr[i]];
+      if (!*edge) {
+        *edge = (u32)m.out.len;
+        for (usize j = 0; j < c; ++j) {
+          vstd_vector_push(u32, (&m.next), 0);
+        }
+        vstd_vector_push(u32, (&m.out), 0);
+        vstd_vector_push(u32, (&m.link), 0);
+        vstd_vector_push(u32, (&m.depth), (u32)i + 1);
+        /* Pushing may move the table, so the edge is read again. */
+        edge = (u32 *)m.next.ptr + state * c + m.classes[ptr[i]];
+      }
+      state = *edge;
+    }
+
+    /* Repeated patterns are appended to the chain of the first one. */
+    u32 *out = (u32 *)m.out.ptr + state;
+    while (*out) {
+      out = (u32 *)m.same.ptr + *out - 1;
+    }
+    *out = (u32)_$i + 1;
+  });
+
+  /* Turn the trie into a DFA in breadth first order, every state's fail
+   * state is shallower, so its row is already complete when it's needed. */
+  u32 *next = (u32 *)m.next.ptr;
+  u32 *out = (u32 *)m.out.ptr;
+  u32 *link = (u32 *)m.link.ptr;
+  u32 *fail = (u32 *)VSTD_CALLOC(m.out.len, sizeof(u32));
+  u32 *queue = (u32 *)VSTD_MALLOC(sizeof(u32) * m.out.len);
+  usize head = 0, tail = 0;
+
+  queue[tail++] = 0;
+  while (head < tail) {
+    u32 state = queue[head++];
+    for (usize i = 0; i < c; ++i) {
+      u32 child = next[state * c + i];
+      u32 fallback = state ? next[fail[state] * c + i] : 0;
+
+      if (!child) {
+        next[state * c + i] = fallback;
+        continue;
+      }
+
+      fail[child] = fallback;
+      link[child] = out[fallback] ? fallback : link[fallback];
+      queue[tail++] = child;
+    }
   }
 
+  VSTD_FREE(queue);
+  VSTD_FREE(fail);
+
+  return m;
+}
+
 /*****************************************************************************
  *
  * @macro
- *   vstd_map_contains
+ *   vstd_matcher_iter
  *
  * @description
- *   Searches the supplied _VSTD_Map for the given key and stores the result in
- *   a variable.
+ *   Helper function to easily iterate trough every match of every pattern in
+ *   the given memory in a single pass, including the overlapping ones. Matches
+ *   are reported in the order of their end, and longer patterns first for the
+ *   same end. Identical patterns are reported in the order of their ids. In
+ *   every iteration it is possible to access the current match as a _VSTD_Match
+ *   from _$iter and current index from _$i.
  *
  * @param[in]
- *   k : Type of the keys stored in _VSTD_Map.
+ *   matcher : _VSTD_Matcher to search with.
  * @param[in]
- *   v : Type of the values stored in _VSTD_Map.
+ *   buf : Memory to search.
  * @param[in]
- *   map : Map to search for the key.
+ *   size : Length of the memory to search.
  * @param[in]
- *   key : Key to search for.
- * @param[out]
- *   result : Reference to the variable that the result will be stored in.
+ *   ... : A single function or a block of code to execute every iteration.
  *
  * */
-#define vstd_map_contains(k, v, map, key, result)                              \
+#define vstd_matcher_iter(matcher, buf, size, ...)                             \
   do {                                                                         \
-    *(result) = false;                                                         \
-    map.cache = -1;                                                            \
-    for (k *_ptr = map.keys.ptr; _ptr < ((k *)map.keys.ptr) + map.keys.len;    \
-         ++_ptr) {                                                             \
-      if (((bool (*)(k, k))map.func_ptr)(*_ptr, key)) {                        \
-        *(result) = true;                                                      \
-        map.cache = ((iptr)_ptr - (iptr)map.keys.ptr) / sizeof(k);             \
-        break;                                                                 \
+    const _VSTD_Matcher *_m = &(matcher);                                      \
+    const u8 *_buf = (const u8 *)(buf);                                        \
+    const u32 *_next = (const u32 *)_m->next.ptr;                              \
+    const u32 *_out = (const u32 *)_m->out.ptr;                                \
+    const u32 *_link = (const u32 *)_m->link.ptr;                              \
+    const u32 *_same = (const u32 *)_m->same.ptr;                              \
+    usize _size = (size);                                                      \
+    usize _$i = 0;                                                             \
+    u32 _state = 0;                                                            \
+    for (usize _pos = 0; _pos < _size; ++_pos) {                               \
+      _state = _next[_state * _m->class_count + _m->classes[_buf[_pos]]];      \
+      u32 _s = _out[_state] ? _state : _link[_state];                          \
+      for (; _s; _s = _link[_s]) {                                             \
+        for (u32 _id = _out[_s]; _id; _id = _same[_id - 1], ++_$i) {           \
+          usize _len = ((usize *)_m->lens.ptr)[_id - 1];                       \
+          _VSTD_Match _$iter = (_VSTD_Match){                                  \
+              .id = _id - 1,                                                   \
+              .offset = _pos + 1 - _len,                                       \
+              .len = _len,                                                     \
+          };                                                                   \
+          __VA_ARGS__;                                                         \
+          (void)(_$i);                                                         \
+          (void)(_$iter);                                                      \
+        }                                                                      \
       }                                                                        \
     }                                                                          \
   } while (0)
 
 /*****************************************************************************
  *
- * @macro
- *   vstd_map_set
+ * @function
+ *   vstd_matcher_find_all
  *
  * @description
- *   Set's the value for the key to the supplied item. If the key is already
- *   present in the given _VSTD_Map, item is just replaced with the new value,
- *   if not both the key and the item are added to respective _VSTD_Vectors.
+ *   Finds every match of every pattern in the given memory, including the
+ *   overlapping ones, in the same order as vstd_matcher_iter.
  *
  * @param[in]
- *   k : Type of the keys stored in _VSTD_Map.
- * @param[in]
- *   v : Type of the values stored in _VSTD_Map.
- * @param[in]
- *   map : Map to set the key and the value.
+ *   matcher : _VSTD_Matcher to search with.
  * @param[in]
- *   key : Key.
+ *   buf : Memory to search.
  * @param[in]
- *   value : Value.
+ *   size : Length of the memory to search.
+ *
+ * @return
+ *   _VSTD_Vector of _VSTD_Matches.
  *
  * */
-#define vstd_map_set(k, v, map, key, value)                                    \
-  do {                                                                         \
-    bool exists;                                                               \
-    vstd_map_contains(k, v, map, key, &exists);                                \
-    if (!exists) {                                                             \
-      vstd_vector_push(k, (&map.keys), key);                                   \
-      vstd_vector_push(v, (&map.vals), value);                                 \
-    } else {                                                                   \
-      vstd_vector_set(v, (&map.vals), map.cache, value);                       \
-    }                                                                          \
-  } while (0)
+VSTD_STATIC VSTD_Vector(_VSTD_Match)
+    vstd_matcher_find_all(const _VSTD_Matcher *matcher, const char *buf,
+                          usize size) {
+  VSTD_Vector(_VSTD_Match) vec = vstd_vector_new(_VSTD_Match);
+  vstd_matcher_iter((*matcher), buf, size,
+                    vstd_vector_push(_VSTD_Match, (&vec), _$iter));
+  return vec;
+}
 
 /*****************************************************************************
  *
- * @macro
- *   vstd_map_get
+ * @function
+ *   vstd_matcher_find_all_string
  *
  * @description
- *   Tries to retrieve a value from the given _VSTD_Map. If successful a pointer
- *   to value is assigned to var, if not var is set to NULL.
+ *   Finds every match of every pattern in the given _VSTD_String, see
+ *   vstd_matcher_find_all.
  *
  * @param[in]
- *   k : Type of the keys stored in _VSTD_Map.
- * @param[in]
- *   v : Type of the values stored in _VSTD_Map.
- * @param[in]
- *   map : Map to get the value from.
+ *   matcher : _VSTD_Matcher to search with.
  * @param[in]
- *   key : Key to access.
- * @param[out]
- *   var : Variable to store the value.
+ *   string : _VSTD_String to search.
+ *
+ * @return
+ *   _VSTD_Vector of _VSTD_Matches.
  *
  * */
-#define vstd_map_get(k, v, map, key, out)                                      \
-  do {                                                                         \
-    bool exists;                                                               \
-    vstd_map_contains(k, v, map, key, &exists);                                \
-    if (!exists) {                                                             \
-      out = NULL;                                                              \
-    } else {                                                                   \
-      out = &(vstd_vector_get(v, map.vals, map.cache));                        \
-    }                                                                          \
-  } while (0)
+VSTD_STATIC VSTD_Vector(_VSTD_Match)
+    vstd_matcher_find_all_string(const _VSTD_Matcher *matcher,
+                                 const _VSTD_String *string) {
+  return vstd_matcher_find_all(matcher, vstd_string_ptr(string),
+                               vstd_string_len(string));
+}
 
 /*****************************************************************************
  *
- * @macro
- *   vstd_map_remove
+ * @function
+ *   vstd_matcher_next
  *
  * @description
- *   Tries to remove the key and its associated value from the given _VSTD_Map.
+ *   Finds the next non-overlapping match in the given memory, starting from
+ *   pos. The leftmost match is reported, and the longest pattern is chosen
+ *   among the ones starting at the same position, so a pattern inside of a
+ *   longer one never splits it. After a match is found the search continues
+ *   only while a longer match could still start at or before it. On success
+ *   pos is moved to the end of the match, so repeated calls yield consecutive
+ *   matches.
  *
  * @param[in]
- *   k : Type of the keys stored in _VSTD_Map.
- * @param[in]
- *   v : Type of the values stored in _VSTD_Map.
+ *   matcher : _VSTD_Matcher to search with.
  * @param[in]
- *   map : Map to remove the key from.
+ *   buf : Memory to search.
  * @param[in]
- *   key : Key to remove.
+ *   size : Length of the memory to search.
+ * @param[in, out]
+ *   pos : Position to start searching from.
+ * @param[out]
+ *   match : Match found.
+ *
+ * @return
+ *   False if there are no more matches, true otherwise.
  *
  * */
-#define vstd_map_remove(k, v, map, key)                                        \
-  do {                                                                         \
-    bool exists;                                                               \
-    vstd_map_contains(k, v, map, key, &exists);                                \
-    if (exists) {                                                              \
-      vstd_vector_remove(k, (&map.keys), map.cache);                           \
-      vstd_vector_remove(v, (&map.vals), map.cache);                           \
-    }                                                                          \
-  } while (0)
+VSTD_STATIC bool vstd_matcher_next(const _VSTD_Matcher *matcher,
+                                   const char *buf, usize size, usize *pos,
+                                   _VSTD_Match *match) {
+  const u8 *ptr = (const u8 *)buf;
+  const u32 *next = (const u32 *)matcher->next.ptr;
+  const u32 *out = (const u32 *)matcher->out.ptr;
+  const u32 *link = (const u32 *)matcher->link.ptr;
+  const u32 *depth = (const u32 *)matcher->depth.ptr;
+  const usize *lens = (const usize *)matcher->lens.ptr;
+
+  bool found = false;
+  u32 state = 0;
+  for (usize i = *pos; i < size; ++i) {
+    state = next[state * matcher->class_count + matcher->classes[ptr[i]]];
+
+    /* Every later match starts inside of the current state's prefix. */
+    if (found && i + 1 - depth[state] > match->offset) {
+      break;
+    }
+
+    u32 s = out[state] ? state : link[state];
+    if (s) {
+      usize len = lens[out[s] - 1];
+      usize offset = i + 1 - len;
+      if (!found || offset < match->offset ||
+          (offset == match->offset && len > match->len)) {
+        match->id = out[s] - 1;
+        match->len = len;
+        match->offset = offset;
+        found = true;
+      }
+    }
+  }
+
+  if (!found) {
+    *pos = size;
+    return false;
+  }
+
+  *pos = match->offset + match->len;
+  return true;
+}
 
 /*****************************************************************************
  *
- * @macro
- *   vstd_map_remove
+ * @function
+ *   vstd_matcher_replace_all
  *
  * @description
- *   Helper function to easily iterate trough the all the keys and values stored
- *   in a _VSTD_Map. In every iteration it is possible to access the current key
- *   and value from _$iter and current index from _$i.
+ *   Replaces every non-overlapping match inside of the given _VSTD_String with
+ *   the replacement. Matches are chosen leftmost-longest as in
+ *   vstd_matcher_next, so every byte of an overlapping longer pattern is
+ *   replaced. If the replacement is not longer than the shortest pattern the
+ *   string is compacted in place in a single pass, otherwise the matches are
+ *   counted first and the result is built into a buffer allocated with the
+ *   exact size.
  *
  * @param[in]
- *   k : Type of the keys stored in _VSTD_Map.
- * @param[in]
- *   v : Type of the values stored in _VSTD_Map.
+ *   matcher : _VSTD_Matcher to search with.
  * @param[in]
- *   map : _VSTD_Map to iterate.
+ *   string : _VSTD_String to modify.
  * @param[in]
- *   ... : A single function or a block of code to execute every iteration.
+ *   rep : Null terminated C string to replace with.
+ *
+ * @return
+ *   Number of replaced matches.
  *
  * */
-#define vstd_map_iter(k, v, map, ...)                                          \
-  do {                                                                         \
-    struct _VSTDMapPair {                                                      \
-      k *key;                                                                  \
-      v *val;                                                                  \
-    };                                                                         \
-    for (usize _$i = 0; _$i < map.keys.len; ++_$i) {                           \
-      struct _VSTDMapPair _$iter = (struct _VSTDMapPair){                      \
-          .key = &(vstd_vector_get(k, map.keys, _$i)),                         \
-          .val = &(vstd_vector_get(v, map.vals, _$i)),                         \
-      };                                                                       \
-      __VA_ARGS__;                                                             \
-      (void)(_$i);                                                             \
-      (void)(_$iter);                                                          \
-    }                                                                          \
-  } while (0)
+VSTD_STATIC usize vstd_matcher_replace_all(const _VSTD_Matcher *matcher,
+                                           _VSTD_String *string,
+                                           const char *rep) {
+  usize rep_len = strlen(rep);
+  char *ptr = vstd_string_ptr(string);
+  usize len = vstd_string_len(string);
+  usize read = 0, pos = 0, count = 0;
+  _VSTD_Match match;
+
+  if (rep_len <= matcher->min_len) {
+    usize write = 0;
+    while (vstd_matcher_next(matcher, ptr, len, &pos, &match)) {
+      memmove(ptr + write, ptr + read, match.offset - read);
+      write += match.offset - read;
+      memcpy(ptr + write, rep, rep_len);
+      write += rep_len;
+      read = pos;
+      count++;
+    }
+
+    if (count) {
+      memmove(ptr + write, ptr + read, len - read);
+      write += len - read;
+      ptr[write] = '\0';
+      _vstd_string_set_len(string, write);
+    }
+    return count;
+  }
+
+  usize new_len = len;
+  while (vstd_matcher_next(matcher, ptr, len, &pos, &match)) {
+    new_len = new_len - match.len + rep_len;
+    count++;
+  }
+  if (!count) {
+    return count;
+  }
+
+  _VSTD_String out =
+      vstd_string_with_allocator(new_len + 1, vstd_string_allocator(string));
+  char *write = vstd_string_ptr(&out);
+
+  pos = 0;
+  while (vstd_matcher_next(matcher, ptr, len, &pos, &match)) {
+    memcpy(write, ptr + read, match.offset - read);
+    write += match.offset - read;
+    memcpy(write, rep, rep_len);
+    write += rep_len;
+    read = pos;
+  }
+  memcpy(write, ptr + read, len - read);
+  write[len - read] = '\0';
+  _vstd_string_set_len(&out, new_len);
+
+  vstd_string_free(string);
+  *string = out;
+
+  return count;
+}
 
 /*****************************************************************************
  *
- * @macro
- *   vstd_map_clear
+ * @function
+ *   vstd_matcher_remove_all
  *
  * @description
- *   Set's given _VSTD_Map's underlying _VSTD_Vector's lengths to 0, basically
- *   soft resetting them. This doesn't actually modify or free the underlying
- *   pointers.
+ *   Removes every non-overlapping match from the given _VSTD_String in a single
+ *   pass, see vstd_matcher_replace_all.
  *
  * @param[in]
- *   k : Type of the keys stored in _VSTD_Map.
- * @param[in]
- *   v : Type of the values stored in _VSTD_Map.
+ *   matcher : _VSTD_Matcher to search with.
  * @param[in]
- *   map : _VSTD_Map to clear.
+ *   string : _VSTD_String to modify.
+ *
+ * @return
+ *   Number of removed matches.
  *
  * */
-#define vstd_map_clear(k, v, map)                                              \
-  do {                                                                         \
-    vstd_vector_clear(k, (&map.keys));                                         \
-    vstd_vector_clear(v, (&map.vals));                                         \
-    map.cache = -1;                                                            \
-  } while (0)
+VSTD_INLINE usize vstd_matcher_remove_all(const _VSTD_Matcher *matcher,
+                                          _VSTD_String *string) {
+  return vstd_matcher_replace_all(matcher, string, "");
+}
 
 /*****************************************************************************
  *
- * @macro
- *   vstd_map_free
+ * @function
+ *   vstd_matcher_free
  *
  * @description
- *   Frees all the memory allocated for the _VSTD_Map by freeing its underlying
- *   _VSTD_Vectors.
+ *   Frees all the memory allocated for the _VSTD_Matcher.
  *
  * @param[in]
- *   k : Type of the keys stored in _VSTD_Map.
- * @param[in]
- *   v : Type of the values stored in _VSTD_Map.
- * @param[in]
- *   map : _VSTD_Map to free.
- *
- * */
-#define vstd_map_free(k, v, map)                                               \
-  do {                                                                         \
-    vstd_vector_free(k, (&map.keys));                                          \
-    vstd_vector_free(v, (&map.vals));                                          \
-    map.cache = -1;                                                            \
-  } while (0)
-
-/*****************************************************************************
- *
- * @section
- *   VSTD Map Predefined Condition Functions
- *
- * @description
- *   Predefined functions that can be supplied to a _VSTD_Map as a compare
- *   function for its keys.
+ *   matcher : _VSTD_Matcher to free.
  *
  * */
-
-#ifndef VSTD_MAP_NO_PREDEFINED_CONDITIONS
-VSTD_STATIC bool vstd_map_condition_isize(isize a, isize b) { return a == b; }
-
-VSTD_STATIC bool vstd_map_condition_usize(usize a, usize b) { return a == b; }
-
-VSTD_STATIC bool vstd_map_condition_string(const _VSTD_String a,
-                                           const _VSTD_String b) {
-  return vstd_string_compare(&a, b.ptr) == VSTD_STRING_EQUAL;
-}
-
-VSTD_STATIC bool vstd_map_condition_void(const void *a, const void *b) {
-  return a == b;
+VSTD_STATIC void vstd_matcher_free(_VSTD_Matcher *matcher) {
+  vstd_vector_free(u32, (&matcher->next));
+  vstd_vector_free(u32, (&matcher->out));
+  vstd_vector_free(u32, (&matcher->link));
+  vstd_vector_free(usize, (&matcher->lens));
+  vstd_vector_free(u32, (&matcher->same));
+  vstd_vector_free(u32, (&matcher->depth));
+  matcher->class_count = 0;
+  matcher->min_len = 0;
 }
-#endif
 
 /*****************************************************************************
  *
@@ -1158,7 +11051,7 @@ VSTD_STATIC bool vstd_map_condition_void(const void *a, const void *b) {
  *
  * @description
  *   Reads the contents of the file at given path into a _VSTD_String. Returns a
- *   NULL _VSTD_String if it fails.
+ *   NULL _VSTD_String if it fails, whose vstd_string_ptr is a NULL pointer.
  *
  * @param[in]
  *   path : Path to the file to read.
@@ -1178,7 +11071,7 @@ VSTD_STATIC _VSTD_String vstd_fs_read_file(const char *path) {
     fprintf(stderr, "Failed to open file at `%s` to read.\n", path);
     perror("ERROR @vstd_fs_read_file");
 #endif
-    return (_VSTD_String){NULL, 0, 0};
+    return _VSTD_STRING_NULL;
   }
 
   fseek(f, 0, SEEK_END);
@@ -1187,18 +11080,20 @@ VSTD_STATIC _VSTD_String vstd_fs_read_file(const char *path) {
 
   _VSTD_String buff = vstd_string_with_capacity(size + 1);
 
-  usize read = fread(buff.ptr, size, 1, f);
+  usize read = fread(vstd_string_ptr(&buff), size, 1, f);
   if (read != 1) {
 #ifdef DEBUG
     fprintf(stderr, "Failed to read file at `%s`.\n", path);
     perror("ERROR @vstd_fs_read_file");
 #endif
-    return (_VSTD_String){NULL, 0, 0};
+    vstd_string_free(&buff);
+    fclose(f);
+    return _VSTD_STRING_NULL;
   }
   fclose(f);
 
-  buff.len = size;
-  buff.ptr[buff.len] = '\0';
+  _vstd_string_set_len(&buff, size);
+  vstd_string_ptr(&buff)[size] = '\0';
 
   return buff;
 }
@@ -1340,18 +11235,19 @@ VSTD_STATIC _VSTD_String vstd_io_read_line(usize max_char) {
 
   _VSTD_String line = vstd_string_with_capacity(max_char);
 
-  fgets(line.ptr, (i32)max_char, stdin);
+  char *buff = vstd_string_ptr(&line);
+  fgets(buff, (i32)max_char, stdin);
 
   usize len = 0;
-  for (char *ptr = line.ptr; ptr < line.ptr + line.cap; ++ptr) {
+  for (char *ptr = buff; ptr < buff + vstd_string_cap(&line); ++ptr) {
     if (*ptr == '\n' || *ptr == '\0') {
-      len = ptr - line.ptr;
+      len = ptr - buff;
       break;
     }
   }
 
-  line.len = len;
-  line.ptr[line.len] = '\0';
+  _vstd_string_set_len(&line, len);
+  buff[len] = '\0';
 
   return line;
 }